@@ -0,0 +1,105 @@
+#include "cpp_http_client/Request.hpp"
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <map>
+#include <chrono>
+#include <random>
+#include <cstdlib> // For std::atoi
+
+// Measures streaming decode throughput per codec. Each iteration decodes one body the way
+// Request::send() does: through a ResponseSink fed in socket-sized chunks, ending in the
+// Response copy, with decoder contexts and body buffers coming from the per-thread pool.
+
+namespace {
+
+const size_t FEED_CHUNK_SIZE = 8 * 1024;
+
+// Semi-compressible JSON-like payload, closer to real API responses than random bytes or a
+// single repeated character.
+std::string make_payload(size_t size) {
+    std::mt19937 rng(42);
+    const char* words[] = {"\"id\":", "\"name\":", "\"status\":\"ok\",", "\"items\":[", "],", "{", "},",
+                           "\"value\":", "true,", "false,", "null,", "\"timestamp\":"};
+    std::string out;
+    out.reserve(size);
+    while (out.size() < size) {
+        out += words[rng() % (sizeof(words) / sizeof(words[0]))];
+        out += std::to_string(rng() % 100000);
+        out += ',';
+    }
+    out.resize(size);
+    return out;
+}
+
+const char* encoding_name(http::encoding::ContentEncoding enc) {
+    switch (enc) {
+        case http::encoding::ContentEncoding::Identity: return "identity";
+        case http::encoding::ContentEncoding::Gzip: return "gzip";
+        case http::encoding::ContentEncoding::Deflate: return "deflate";
+        case http::encoding::ContentEncoding::Zstd: return "zstd";
+        default: return "unsupported";
+    }
+}
+
+void run_codec(http::encoding::ContentEncoding enc, const std::string& payload, int iterations) {
+    std::string encoded = http::encoding::encode(enc, payload);
+    std::map<std::string, std::string> headers = {{"Content-Length", std::to_string(encoded.size())}};
+    if (enc != http::encoding::ContentEncoding::Identity) headers["Content-Encoding"] = encoding_name(enc);
+
+    bool matches = true;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        http::ResponseSink sink(true);
+        sink.begin(http::HTTP_STATUS_OK, headers);
+        for (size_t offset = 0; offset < encoded.size(); offset += FEED_CHUNK_SIZE) {
+            sink.write(encoded.data() + offset, std::min(FEED_CHUNK_SIZE, encoded.size() - offset));
+        }
+        http::Response response = sink.finish();
+        if (i == 0) matches = response.body() == payload;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (!matches) {
+        std::cerr << encoding_name(enc) << ": decoded body does not match the input" << std::endl;
+        std::exit(1);
+    }
+
+    double total_mb = static_cast<double>(payload.size()) * iterations / (1024.0 * 1024.0);
+    std::cout << std::left << std::setw(10) << encoding_name(enc)
+              << std::right << std::setw(12) << encoded.size()
+              << std::setw(10) << std::fixed << std::setprecision(2)
+              << static_cast<double>(payload.size()) / encoded.size()
+              << std::setw(14) << std::setprecision(1) << total_mb / seconds
+              << std::setw(14) << std::setprecision(2) << seconds * 1e6 / iterations << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    // Usage: DecompressionBenchmark [body_bytes] [iterations]
+    size_t body_size = argc > 1 ? static_cast<size_t>(std::atoi(argv[1])) : 256 * 1024;
+    int iterations = argc > 2 ? std::atoi(argv[2]) : 200;
+
+    std::string payload = make_payload(body_size);
+    std::cout << "Decoded body: " << body_size << " bytes, " << iterations << " iterations" << std::endl;
+    std::cout << std::left << std::setw(10) << "codec"
+              << std::right << std::setw(12) << "encoded" << std::setw(10) << "ratio"
+              << std::setw(14) << "MB/s (out)" << std::setw(14) << "us/body" << std::endl;
+
+    const http::encoding::ContentEncoding codecs[] = {
+        http::encoding::ContentEncoding::Identity,
+        http::encoding::ContentEncoding::Gzip,
+        http::encoding::ContentEncoding::Deflate,
+        http::encoding::ContentEncoding::Zstd,
+    };
+    for (auto enc : codecs) {
+        if (!http::encoding::is_supported(enc)) {
+            std::cout << std::left << std::setw(10) << encoding_name(enc) << "  (not compiled in)" << std::endl;
+            continue;
+        }
+        run_codec(enc, payload, iterations);
+    }
+    return 0;
+}
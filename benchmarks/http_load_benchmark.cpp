@@ -0,0 +1,406 @@
+#include "cpp_http_client/Client.hpp"
+#include "loopback_server.hpp"
+#include "loopback_transport.hpp"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <map>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <future>
+#include <algorithm> // For std::sort
+#include <cstdlib>   // For std::atoi, std::atof, std::strtoull, std::malloc
+#include <cstring>   // For std::strchr
+#include <new>       // For std::bad_alloc
+
+#include <sys/resource.h>
+
+// Load generator for Client against an in-process loopback HTTP server (see loopback_server.hpp).
+// Every request goes through Client::async_send, so it is queued on the selected executor
+// (shared ThreadPool or ShardedRuntime, with its priority and deadline) and its body is decoded
+// by ResponseSink, exactly as in an application.
+//   closed - 'concurrency' threads each submit a request and wait for it, back to back;
+//            throughput is whatever the client and server sustain.
+//   open   - requests are submitted at a constant 'rate' whether or not earlier ones have
+//            finished. Latency runs from each request's scheduled start to the end of its
+//            transport call, so time spent queued in the executor counts (no coordinated
+//            omission).
+// Reports throughput and latency percentiles per priority class, requests dropped by their
+// deadline, heap allocations per request on client threads and client CPU time per request
+// (process CPU minus the server threads' CPU).
+
+namespace {
+
+std::atomic<uint64_t> g_allocations{0};
+
+// Harness bookkeeping (recording results) is excluded from the allocation count.
+bool& untracked() {
+    thread_local bool value = false;
+    return value;
+}
+
+struct Untracked {
+    Untracked() { untracked() = true; }
+    ~Untracked() { untracked() = false; }
+};
+
+void* counted_alloc(size_t size) {
+    if (!untracked() && !bench::is_server_thread()) g_allocations.fetch_add(1, std::memory_order_relaxed);
+    void* p = std::malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+} // namespace
+
+void* operator new(size_t size) { return counted_alloc(size); }
+void* operator new[](size_t size) { return counted_alloc(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { ::operator delete(p); }
+void operator delete[](void* p, size_t) noexcept { ::operator delete[](p); }
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using http::utils::Priority;
+
+const char* const BENCH_ID_HEADER = "X-Bench-Id";
+const size_t CLASS_COUNT = 3;
+const char* const CLASS_NAMES[CLASS_COUNT] = {"high", "normal", "low"};
+
+struct Options {
+    bool open = false;
+    double rate = 1000;
+    size_t concurrency = 8;
+    std::chrono::milliseconds duration{2000};
+    http::ExecutionMode executor = http::ExecutionMode::SharedPool;
+    size_t mix[CLASS_COUNT] = {0, 1, 0}; // Weights of High, Normal, Low
+    std::chrono::milliseconds deadline{0}; // 0: no deadline
+    bench::LoopbackServerConfig server;
+    std::string encoding_name = "identity";
+};
+
+enum class Outcome { Pending, Ok, Error, Expired };
+
+struct Sample {
+    Priority priority = Priority::Normal;
+    Outcome outcome = Outcome::Pending;
+    int64_t latency_ns = 0;
+    size_t body_bytes = 0; // Decoded
+};
+
+// Open loop: completion times, written by the transport wrapper on the executor thread and read
+// after the request's future is ready.
+struct OpenSlot {
+    Clock::time_point intended;
+    Clock::time_point done;
+};
+
+std::vector<OpenSlot>* g_open_slots = nullptr;
+
+// Wraps the loopback transport to timestamp each open-loop request (tagged with BENCH_ID_HEADER)
+// when its response has been received and decoded, independent of when the harness collects it.
+struct TimedTransport {
+    bench::LoopbackTransport inner;
+
+    void operator()(const http::Request& request, http::ResponseSink& sink) const {
+        struct Stamp {
+            OpenSlot* slot;
+            ~Stamp() { if (slot) slot->done = Clock::now(); }
+        } stamp{find_slot(request)};
+        inner(request, sink);
+    }
+
+    static OpenSlot* find_slot(const http::Request& request) {
+        if (!g_open_slots) return nullptr;
+        auto it = request.get_headers().find(BENCH_ID_HEADER);
+        if (it == request.get_headers().end()) return nullptr;
+        return &(*g_open_slots)[std::strtoull(it->second.c_str(), nullptr, 10)];
+    }
+};
+
+// Deterministic interleaving of the classes in proportion to their weights
+std::vector<Priority> make_schedule(const size_t (&mix)[CLASS_COUNT]) {
+    std::vector<Priority> schedule;
+    for (size_t c = 0; c < CLASS_COUNT; ++c) {
+        for (size_t i = 0; i < mix[c]; ++i) schedule.push_back(static_cast<Priority>(c));
+    }
+    if (schedule.empty()) schedule.push_back(Priority::Normal);
+    for (size_t i = 0; i < schedule.size(); ++i) std::swap(schedule[i], schedule[(i * 7919) % schedule.size()]);
+    return schedule;
+}
+
+http::Request make_request(const std::string& url, Priority priority, const Options& options) {
+    http::Request request;
+    request.url(url).method("GET").priority(priority);
+    if (options.deadline.count() > 0) request.deadline(Clock::now() + options.deadline);
+    return request;
+}
+
+// Waits for one response and classifies it.
+void collect(std::future<http::Response>& future, Sample& sample) {
+    try {
+        http::Response response = future.get();
+        sample.outcome = response.status_code() == http::HTTP_STATUS_OK ? Outcome::Ok : Outcome::Error;
+        sample.body_bytes = response.body().size();
+    } catch (const http::utils::DeadlineExceeded&) {
+        sample.outcome = Outcome::Expired;
+    } catch (const std::exception&) {
+        sample.outcome = Outcome::Error;
+    }
+}
+
+std::vector<Sample> run_closed(const std::string& url, const Options& options) {
+    std::vector<Priority> schedule = make_schedule(options.mix);
+    std::vector<std::vector<Sample>> samples(options.concurrency);
+    for (auto& per_thread : samples) per_thread.reserve(16 * 1024);
+    std::vector<std::thread> users;
+
+    Clock::time_point end = Clock::now() + options.duration;
+    for (size_t t = 0; t < options.concurrency; ++t) {
+        users.emplace_back([&, t] {
+            std::vector<Sample>& mine = samples[t];
+            size_t next = t;
+            for (Clock::time_point sent = Clock::now(); sent < end; sent = Clock::now()) {
+                Sample sample;
+                sample.priority = schedule[next++ % schedule.size()];
+                std::future<http::Response> future = http::Client::async_send(make_request(url, sample.priority, options));
+                collect(future, sample);
+                sample.latency_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - sent).count();
+                Untracked guard;
+                mine.push_back(sample);
+            }
+        });
+    }
+    for (auto& u : users) u.join();
+
+    Untracked guard;
+    std::vector<Sample> all;
+    for (const auto& per_thread : samples) all.insert(all.end(), per_thread.begin(), per_thread.end());
+    return all;
+}
+
+std::vector<Sample> run_open(const std::string& url, const Options& options) {
+    std::vector<Priority> schedule = make_schedule(options.mix);
+    size_t total = static_cast<size_t>(options.rate * options.duration.count() / 1000.0);
+    auto interval = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / options.rate));
+
+    std::vector<Sample> samples;
+    std::vector<OpenSlot> slots;
+    std::vector<std::future<http::Response>> futures;
+    {
+        Untracked guard;
+        samples.resize(total);
+        slots.resize(total);
+        futures.resize(total);
+    }
+    g_open_slots = &slots;
+
+    Clock::time_point start = Clock::now();
+    for (size_t i = 0; i < total; ++i) {
+        slots[i].intended = start + interval * static_cast<int64_t>(i);
+        std::this_thread::sleep_until(slots[i].intended);
+        samples[i].priority = schedule[i % schedule.size()];
+        http::Request request = make_request(url, samples[i].priority, options);
+        {
+            Untracked guard; // The tag only exists for the harness
+            request.header(BENCH_ID_HEADER, std::to_string(i));
+        }
+        futures[i] = http::Client::async_send(request);
+    }
+
+    for (size_t i = 0; i < total; ++i) {
+        collect(futures[i], samples[i]);
+        if (samples[i].outcome != Outcome::Expired) {
+            samples[i].latency_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(slots[i].done - slots[i].intended).count();
+        }
+    }
+    g_open_slots = nullptr;
+    return samples;
+}
+
+double percentile_us(const std::vector<int64_t>& sorted, double p) {
+    if (sorted.empty()) return 0;
+    size_t index = static_cast<size_t>(p * (sorted.size() - 1) + 0.5);
+    return sorted[index] / 1000.0;
+}
+
+void print_row(const std::string& name, const std::vector<const Sample*>& samples) {
+    uint64_t errors = 0, expired = 0;
+    std::vector<int64_t> latencies;
+    latencies.reserve(samples.size());
+    for (const Sample* s : samples) {
+        if (s->outcome == Outcome::Expired) {
+            ++expired;
+            continue;
+        }
+        if (s->outcome == Outcome::Error) ++errors;
+        latencies.push_back(s->latency_ns);
+    }
+    std::sort(latencies.begin(), latencies.end());
+    std::cout << std::left << std::setw(8) << name << std::right << std::fixed << std::setprecision(0)
+              << std::setw(10) << samples.size() << std::setw(8) << errors << std::setw(9) << expired
+              << std::setw(10) << percentile_us(latencies, 0.50) << std::setw(10) << percentile_us(latencies, 0.99)
+              << std::setw(10) << percentile_us(latencies, 0.999) << std::setw(10) << percentile_us(latencies, 1.0)
+              << std::endl;
+}
+
+double cpu_seconds() {
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6 + usage.ru_stime.tv_sec + usage.ru_stime.tv_usec / 1e6;
+}
+
+void usage() {
+    std::cerr << "Usage: HttpLoadBenchmark [key=value ...]\n"
+                 "  mode=closed|open     closed: 'concurrency' users back to back; open: constant 'rate' (closed)\n"
+                 "  rate=N               open-loop arrival rate, requests/s (1000)\n"
+                 "  concurrency=N        closed-loop users (8)\n"
+                 "  duration_ms=N        run length (2000)\n"
+                 "  executor=pool|shards Client::execution_mode: SharedPool or PerCoreShards (pool)\n"
+                 "  mix=H:N:L            weights of High:Normal:Low requests (0:1:0)\n"
+                 "  deadline_ms=N        per-request deadline, 0 for none (0)\n"
+                 "  latency_us=N         server service time (100)\n"
+                 "  jitter_us=N          extra uniform service time (0)\n"
+                 "  body=N body_max=N    response body size range in bytes (256, fixed)\n"
+                 "  error_rate=F         fraction of 500 responses (0)\n"
+                 "  encoding=identity|gzip|deflate|zstd  server Content-Encoding (identity)"
+              << std::endl;
+}
+
+bool parse_options(int argc, char* argv[], Options& options) {
+    options.server.latency = std::chrono::microseconds(100);
+    for (int i = 1; i < argc; ++i) {
+        const char* eq = std::strchr(argv[i], '=');
+        if (!eq) return false;
+        std::string key(argv[i], static_cast<size_t>(eq - argv[i]));
+        std::string value(eq + 1);
+        if (key == "mode" && (value == "closed" || value == "open")) {
+            options.open = value == "open";
+        } else if (key == "rate") {
+            options.rate = std::atof(value.c_str());
+        } else if (key == "concurrency") {
+            options.concurrency = static_cast<size_t>(std::atoi(value.c_str()));
+        } else if (key == "duration_ms") {
+            options.duration = std::chrono::milliseconds(std::atoi(value.c_str()));
+        } else if (key == "executor" && (value == "pool" || value == "shards")) {
+            options.executor = value == "pool" ? http::ExecutionMode::SharedPool : http::ExecutionMode::PerCoreShards;
+        } else if (key == "mix") {
+            const char* p = value.c_str();
+            for (size_t c = 0; c < CLASS_COUNT; ++c) {
+                char* end = nullptr;
+                options.mix[c] = std::strtoull(p, &end, 10);
+                if (end == p || (c + 1 < CLASS_COUNT && *end != ':') || (c + 1 == CLASS_COUNT && *end != '\0')) return false;
+                p = end + 1;
+            }
+        } else if (key == "deadline_ms") {
+            options.deadline = std::chrono::milliseconds(std::atoi(value.c_str()));
+        } else if (key == "latency_us") {
+            options.server.latency = std::chrono::microseconds(std::atoi(value.c_str()));
+        } else if (key == "jitter_us") {
+            options.server.latency_jitter = std::chrono::microseconds(std::atoi(value.c_str()));
+        } else if (key == "body") {
+            options.server.body_bytes = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (key == "body_max") {
+            options.server.body_bytes_max = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (key == "error_rate") {
+            options.server.error_rate = std::atof(value.c_str());
+        } else if (key == "encoding") {
+            options.server.encoding = http::encoding::parse_content_encoding(value);
+            options.encoding_name = value;
+            if (options.server.encoding == http::encoding::ContentEncoding::Unsupported) return false;
+            if (!http::encoding::is_supported(options.server.encoding)) {
+                std::cerr << "encoding=" << value << " is not compiled into this build" << std::endl;
+                return false;
+            }
+        } else {
+            return false;
+        }
+    }
+    if (options.concurrency == 0) options.concurrency = 1;
+    if (options.rate <= 0) options.rate = 1;
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parse_options(argc, argv, options)) {
+        usage();
+        return 1;
+    }
+    const bench::LoopbackServerConfig& config = options.server;
+
+    http::Client::execution_mode(options.executor);
+    bool sharded = options.executor == http::ExecutionMode::PerCoreShards;
+    size_t workers = sharded ? http::Client::get_sharded_runtime().size() : http::Client::get_thread_pool().size();
+
+    bench::LoopbackHttpServer server(config);
+    http::Request::set_transport(TimedTransport{bench::LoopbackTransport(server.port())});
+    std::string url = "http://127.0.0.1:" + std::to_string(server.port()) + "/bench";
+
+    std::cout << (options.open ? "Open loop at " + std::to_string(static_cast<long>(options.rate)) + " req/s"
+                               : "Closed loop, " + std::to_string(options.concurrency) + " users")
+              << ", " << options.duration.count() << " ms via " << (sharded ? "PerCoreShards" : "SharedPool")
+              << " (" << workers << " workers), mix " << options.mix[0] << ":" << options.mix[1] << ":" << options.mix[2]
+              << ", deadline ";
+    if (options.deadline.count() > 0) {
+        std::cout << options.deadline.count() << " ms";
+    } else {
+        std::cout << "none";
+    }
+    std::cout << "; server latency " << config.latency.count() << "+" << config.latency_jitter.count()
+              << " us, body " << config.body_bytes;
+    if (config.body_bytes_max > config.body_bytes) std::cout << "-" << config.body_bytes_max;
+    std::cout << " B " << options.encoding_name << ", error rate " << config.error_rate << std::endl;
+
+    // Warm up: executor threads, each thread's loopback connection, decoder pools, lazy statics
+    {
+        std::vector<std::future<http::Response>> warmup;
+        for (size_t i = 0; i < workers * 4; ++i) warmup.push_back(http::Client::async_get(url));
+        for (auto& f : warmup) f.wait();
+    }
+
+    uint64_t allocations_before = g_allocations.load();
+    double cpu_before = cpu_seconds();
+    auto server_cpu_before = server.cpu_time();
+    Clock::time_point start = Clock::now();
+
+    std::vector<Sample> samples = options.open ? run_open(url, options) : run_closed(url, options);
+
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    uint64_t allocations = g_allocations.load() - allocations_before;
+    double server_cpu = std::chrono::duration<double>(server.cpu_time() - server_cpu_before).count();
+    double client_cpu = cpu_seconds() - cpu_before - server_cpu;
+    http::Request::set_transport(nullptr);
+
+    Untracked guard;
+    std::vector<const Sample*> all;
+    std::vector<const Sample*> by_class[CLASS_COUNT];
+    uint64_t completed = 0, body_bytes = 0;
+    for (const Sample& s : samples) {
+        all.push_back(&s);
+        by_class[static_cast<size_t>(s.priority)].push_back(&s);
+        if (s.outcome != Outcome::Expired) ++completed;
+        body_bytes += s.body_bytes;
+    }
+
+    std::cout << std::left << std::setw(8) << "class" << std::right << std::setw(10) << "requests" << std::setw(8) << "errors"
+              << std::setw(9) << "expired" << std::setw(10) << "p50 us" << std::setw(10) << "p99 us"
+              << std::setw(10) << "p999 us" << std::setw(10) << "max us" << std::endl;
+    for (size_t c = 0; c < CLASS_COUNT; ++c) {
+        if (!by_class[c].empty()) print_row(CLASS_NAMES[c], by_class[c]);
+    }
+    print_row("all", all);
+
+    double per_request = all.empty() ? 0.0 : 1.0 / all.size();
+    std::cout << std::fixed << std::setprecision(0) << "req/s " << (seconds > 0 ? completed / seconds : 0.0)
+              << std::setprecision(1) << ", allocs/req " << allocations * per_request
+              << ", cpu us/req " << client_cpu * 1e6 * per_request
+              << std::setprecision(0) << ", decoded body B/req " << body_bytes * per_request << std::endl;
+    return 0;
+}
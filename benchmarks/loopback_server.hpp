@@ -0,0 +1,284 @@
+#ifndef CPP_HTTP_CLIENT_BENCHMARKS_LOOPBACK_SERVER_HPP
+#define CPP_HTTP_CLIENT_BENCHMARKS_LOOPBACK_SERVER_HPP
+
+// In-process HTTP/1.1 server on 127.0.0.1 for benchmarks. One thread per keep-alive connection;
+// each response can be delayed, sized, compressed and failed according to LoopbackServerConfig.
+
+#include "cpp_http_client/ContentDecoder.hpp"
+#include "socket_io.hpp"
+#include <string>
+#include <vector>
+#include <list>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <algorithm> // For std::max
+#include <cctype>    // For std::tolower
+#include <cstdlib>   // For std::strtoull
+#include <ctime>     // For clock_gettime
+#include <stdexcept> // For std::runtime_error
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace bench {
+
+struct LoopbackServerConfig {
+    // Service time per request: uniform in [latency, latency + latency_jitter]
+    std::chrono::microseconds latency{0};
+    std::chrono::microseconds latency_jitter{0};
+    // Response body size: uniform in [body_bytes, body_bytes_max] (max <= min means fixed)
+    size_t body_bytes = 256;
+    size_t body_bytes_max = 0;
+    // Fraction of requests answered with 500 Internal Server Error
+    double error_rate = 0.0;
+    // Content-Encoding of successful bodies, used when the request's Accept-Encoding lists it.
+    // Bodies are compressed once at startup, at up to ENCODED_VARIANTS sizes across the range.
+    http::encoding::ContentEncoding encoding = http::encoding::ContentEncoding::Identity;
+};
+
+// Set on server threads so the load generator can exclude server-side work from its
+// client-side allocation counts.
+inline bool& is_server_thread() {
+    thread_local bool server = false;
+    return server;
+}
+
+class LoopbackHttpServer {
+public:
+    explicit LoopbackHttpServer(const LoopbackServerConfig& config)
+        : config_(config), stop_(false), requests_(0), errors_(0), cpu_ns_(0) {
+        size_t max_body = std::max(config_.body_bytes, config_.body_bytes_max);
+        body_ = make_body(max_body);
+        if (config_.encoding != http::encoding::ContentEncoding::Identity) {
+            encoding_token_ = encoding_token(config_.encoding);
+            size_t variants = config_.body_bytes_max > config_.body_bytes ? ENCODED_VARIANTS : 1;
+            for (size_t i = 0; i < variants; ++i) {
+                size_t size = variants == 1 ? config_.body_bytes
+                                            : config_.body_bytes + (max_body - config_.body_bytes) * i / (variants - 1);
+                encoded_.push_back(http::encoding::encode(config_.encoding, body_.substr(0, size)));
+            }
+        }
+
+        listen_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+        int one = 1;
+        setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        sockaddr_in addr = sockaddr_in();
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = 0;
+        if (::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || ::listen(listen_fd_, 1024) != 0) {
+            ::close(listen_fd_);
+            throw std::runtime_error("LoopbackHttpServer: failed to listen on 127.0.0.1");
+        }
+        socklen_t len = sizeof(addr);
+        getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &len);
+        port_ = ntohs(addr.sin_port);
+
+        acceptor_ = std::thread([this] { accept_loop(); });
+    }
+
+    ~LoopbackHttpServer() {
+        stop_ = true;
+        ::shutdown(listen_fd_, SHUT_RDWR);
+        acceptor_.join();
+        ::close(listen_fd_);
+        {
+            std::unique_lock<std::mutex> lock(connections_mutex_);
+            for (int fd : connection_fds_) ::shutdown(fd, SHUT_RDWR);
+        }
+        for (auto& t : connection_threads_) t.join();
+    }
+
+    LoopbackHttpServer(const LoopbackHttpServer&) = delete;
+    LoopbackHttpServer& operator=(const LoopbackHttpServer&) = delete;
+
+    unsigned short port() const { return port_; }
+    uint64_t requests() const { return requests_.load(); }
+    uint64_t errors() const { return errors_.load(); }
+    // CPU consumed by server threads, so it can be subtracted from process CPU time
+    std::chrono::nanoseconds cpu_time() const { return std::chrono::nanoseconds(cpu_ns_.load()); }
+
+private:
+    static constexpr size_t ENCODED_VARIANTS = 16;
+
+    // JSON-like text, so compressed bodies get a realistic ratio rather than a degenerate one
+    static std::string make_body(size_t size) {
+        static const char* const words[] = {"\"id\":", "\"name\":", "\"status\":\"ok\",", "\"items\":[", "],",
+                                            "{", "},", "\"value\":", "true,", "false,", "null,"};
+        std::mt19937 rng(7);
+        std::string body;
+        body.reserve(size + 32);
+        while (body.size() < size) {
+            body += words[rng() % (sizeof(words) / sizeof(words[0]))];
+            body += std::to_string(rng() % 100000);
+            body += ',';
+        }
+        body.resize(size);
+        return body;
+    }
+
+    static const char* encoding_token(http::encoding::ContentEncoding enc) {
+        switch (enc) {
+            case http::encoding::ContentEncoding::Gzip: return "gzip";
+            case http::encoding::ContentEncoding::Deflate: return "deflate";
+            case http::encoding::ContentEncoding::Zstd: return "zstd";
+            default: return "identity";
+        }
+    }
+
+    static uint64_t thread_cpu_ns() {
+        timespec ts;
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+        return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+    }
+
+    void accept_loop() {
+        is_server_thread() = true;
+        while (!stop_) {
+            int fd = ::accept(listen_fd_, nullptr, nullptr);
+            if (fd < 0) continue;
+            int one = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            std::unique_lock<std::mutex> lock(connections_mutex_);
+            if (stop_) {
+                ::close(fd);
+                break;
+            }
+            connection_fds_.push_back(fd);
+            connection_threads_.emplace_back([this, fd] { serve(fd); });
+        }
+    }
+
+    void serve(int fd) {
+        is_server_thread() = true;
+        std::mt19937_64 rng(static_cast<uint64_t>(fd) * 0x9E3779B97F4A7C15ull);
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+        std::string buffer;
+        std::string response;
+        uint64_t cpu_mark = thread_cpu_ns();
+
+        bool accepts_encoding = false;
+        while (!stop_ && read_request(fd, buffer, encoding_token_, accepts_encoding)) {
+            // Simulated service time; sleeping does not count as server CPU
+            auto delay = config_.latency;
+            if (config_.latency_jitter.count() > 0) {
+                delay += std::chrono::microseconds(static_cast<int64_t>(unit(rng) * config_.latency_jitter.count()));
+            }
+            if (delay.count() > 0) std::this_thread::sleep_for(delay);
+
+            bool fail = config_.error_rate > 0 && unit(rng) < config_.error_rate;
+            size_t body_size = config_.body_bytes;
+            if (config_.body_bytes_max > config_.body_bytes) {
+                body_size += static_cast<size_t>(unit(rng) * (config_.body_bytes_max - config_.body_bytes + 1));
+                if (body_size > config_.body_bytes_max) body_size = config_.body_bytes_max;
+            }
+            if (fail) body_size = 0;
+
+            const std::string* encoded = nullptr;
+            if (!fail && accepts_encoding && !encoded_.empty()) {
+                // Nearest pre-compressed size at or below the drawn one
+                size_t span = std::max(config_.body_bytes, config_.body_bytes_max) - config_.body_bytes;
+                size_t index = span == 0 ? 0 : (body_size - config_.body_bytes) * (encoded_.size() - 1) / span;
+                encoded = &encoded_[index];
+            }
+
+            response.assign(fail ? "HTTP/1.1 500 Internal Server Error\r\n" : "HTTP/1.1 200 OK\r\n");
+            response += "Content-Type: application/json\r\n";
+            if (encoded) {
+                response += "Content-Encoding: ";
+                response += encoding_token_;
+                response += "\r\n";
+            }
+            response += "Content-Length: ";
+            response += std::to_string(encoded ? encoded->size() : body_size);
+            response += "\r\n\r\n";
+            if (encoded) {
+                response += *encoded;
+            } else {
+                response.append(body_.data(), body_size);
+            }
+            if (!send_all(fd, response)) break;
+
+            ++requests_;
+            if (fail) ++errors_;
+            uint64_t now = thread_cpu_ns();
+            cpu_ns_ += now - cpu_mark;
+            cpu_mark = now;
+        }
+        std::unique_lock<std::mutex> lock(connections_mutex_);
+        connection_fds_.remove(fd); // Before close(), so the destructor never touches a reused fd
+        ::close(fd);
+    }
+
+    // Consumes one request (headers, then Content-Length bytes of body) from the front of
+    // 'buffer', reading more as needed, and sets 'accepts' if its Accept-Encoding mentions
+    // 'token' (nullptr: never). Returns false once the peer has closed the connection.
+    static bool read_request(int fd, std::string& buffer, const char* token, bool& accepts) {
+        char chunk[16 * 1024];
+        size_t header_end;
+        while ((header_end = buffer.find("\r\n\r\n")) == std::string::npos) {
+            ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+            if (n <= 0) return false;
+            buffer.append(chunk, static_cast<size_t>(n));
+        }
+        size_t content_length = 0;
+        size_t value = find_header_value(buffer, header_end, "content-length:");
+        if (value != std::string::npos) content_length = std::strtoull(buffer.c_str() + value, nullptr, 10);
+        accepts = false;
+        if (token && (value = find_header_value(buffer, header_end, "accept-encoding:")) != std::string::npos) {
+            size_t eol = buffer.find("\r\n", value);
+            size_t found = buffer.find(token, value);
+            accepts = found != std::string::npos && found < eol;
+        }
+        while (buffer.size() < header_end + 4 + content_length) {
+            ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+            if (n <= 0) return false;
+            buffer.append(chunk, static_cast<size_t>(n));
+        }
+        buffer.erase(0, header_end + 4 + content_length);
+        return true;
+    }
+
+    // Offset of the value of a (lowercase) header name within the header block, or npos
+    static size_t find_header_value(const std::string& buffer, size_t header_end, const char* name) {
+        size_t name_len = std::char_traits<char>::length(name);
+        for (size_t line = buffer.find("\r\n"); line != std::string::npos && line < header_end;
+             line = buffer.find("\r\n", line + 2)) {
+            size_t start = line + 2;
+            if (start + name_len > header_end) break;
+            bool match = true;
+            for (size_t i = 0; i < name_len && match; ++i) {
+                match = std::tolower(static_cast<unsigned char>(buffer[start + i])) == name[i];
+            }
+            if (match) return start + name_len;
+        }
+        return std::string::npos;
+    }
+
+    LoopbackServerConfig config_;
+    std::string body_;
+    std::vector<std::string> encoded_; // config_.encoding bodies, ascending size; empty for identity
+    const char* encoding_token_ = nullptr;
+    int listen_fd_;
+    unsigned short port_;
+    std::atomic<bool> stop_;
+    std::thread acceptor_;
+
+    std::mutex connections_mutex_;
+    std::list<int> connection_fds_;
+    std::vector<std::thread> connection_threads_;
+
+    std::atomic<uint64_t> requests_;
+    std::atomic<uint64_t> errors_;
+    std::atomic<uint64_t> cpu_ns_;
+};
+
+} // namespace bench
+
+#endif // CPP_HTTP_CLIENT_BENCHMARKS_LOOPBACK_SERVER_HPP
@@ -0,0 +1,169 @@
+#ifndef CPP_HTTP_CLIENT_BENCHMARKS_LOOPBACK_TRANSPORT_HPP
+#define CPP_HTTP_CLIENT_BENCHMARKS_LOOPBACK_TRANSPORT_HPP
+
+// Minimal HTTP/1.1 socket transport for Request::set_transport(), used by the benchmarks to
+// drive Client against LoopbackHttpServer. Each calling thread keeps one keep-alive connection
+// to 127.0.0.1:<port>; responses must carry Content-Length (which the loopback server does).
+
+#include "cpp_http_client/Request.hpp"
+#include "socket_io.hpp"
+#include <string>
+#include <map>
+#include <algorithm> // For std::min
+#include <cstdlib>   // For std::strtoull
+#include <stdexcept> // For std::runtime_error
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace bench {
+
+class LoopbackTransport {
+public:
+    explicit LoopbackTransport(unsigned short port) : port_(port) {}
+
+    void operator()(const http::Request& request, http::ResponseSink& sink) const {
+        Connection& connection = thread_connection();
+        serialize(request, connection.out);
+        // A pooled connection may have been closed by the server; retry once on a fresh one.
+        // Once the request was written it may have reached the server, so only idempotent
+        // requests are re-sent after a failed read.
+        for (int attempt = 0; attempt < 2; ++attempt) {
+            if (connection.fd < 0) connection.open(port_);
+            bool sent = send_all(connection.fd, connection.out);
+            if (sent && read_response(connection, sink)) return;
+            connection.close();
+            if (sent && !request.is_idempotent()) break;
+        }
+        throw std::runtime_error("LoopbackTransport: request to port " + std::to_string(port_) + " failed");
+    }
+
+private:
+    struct Connection {
+        int fd = -1;
+        unsigned short port = 0;
+        std::string in;  // Bytes received but not yet consumed
+        std::string out; // Reused request buffer
+
+        void open(unsigned short target) {
+            fd = ::socket(AF_INET, SOCK_STREAM, 0);
+            sockaddr_in addr = sockaddr_in();
+            addr.sin_family = AF_INET;
+            addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            addr.sin_port = htons(target);
+            if (fd < 0 || ::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+                close();
+                throw std::runtime_error("LoopbackTransport: connect to port " + std::to_string(target) + " failed");
+            }
+            int one = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            port = target;
+            in.clear();
+        }
+
+        void close() {
+            if (fd >= 0) ::close(fd);
+            fd = -1;
+            in.clear();
+        }
+
+        ~Connection() { close(); }
+    };
+
+    Connection& thread_connection() const {
+        thread_local Connection connection;
+        if (connection.fd >= 0 && connection.port != port_) connection.close(); // Different server
+        return connection;
+    }
+
+    static void serialize(const http::Request& request, std::string& out) {
+        out.assign(request.get_method());
+        out += ' ';
+        out += request.get_path();
+        out += " HTTP/1.1\r\nHost: ";
+        out += request.get_authority();
+        out += "\r\n";
+        for (const auto& pair : request.get_headers()) {
+            out += pair.first;
+            out += ": ";
+            out += pair.second;
+            out += "\r\n";
+        }
+        if (!request.get_body().empty() || request.get_method() == "POST") {
+            out += "Content-Length: ";
+            out += std::to_string(request.get_body().size());
+            out += "\r\n";
+        }
+        out += "\r\n";
+        out += request.get_body();
+    }
+
+    static bool fill(Connection& connection) {
+        char chunk[16 * 1024];
+        ssize_t n = ::recv(connection.fd, chunk, sizeof(chunk), 0);
+        if (n <= 0) return false;
+        connection.in.append(chunk, static_cast<size_t>(n));
+        return true;
+    }
+
+    // Parses the status line and headers, then hands the Content-Length body to 'sink' piece by
+    // piece as it is received. Bytes past the body stay buffered for the next response.
+    static bool read_response(Connection& connection, http::ResponseSink& sink) {
+        std::string& in = connection.in;
+        size_t header_end;
+        while ((header_end = in.find("\r\n\r\n")) == std::string::npos) {
+            if (!fill(connection)) return false;
+        }
+
+        // Status line: "HTTP/1.1 200 OK"
+        size_t line_end = in.find("\r\n");
+        size_t space = in.find(' ');
+        if (space == std::string::npos || space > line_end) return false;
+        int status = std::atoi(in.c_str() + space + 1);
+
+        std::map<std::string, std::string> headers;
+        size_t content_length = 0;
+        for (size_t pos = line_end + 2; pos < header_end;) {
+            size_t eol = in.find("\r\n", pos);
+            size_t colon = in.find(':', pos);
+            if (colon != std::string::npos && colon < eol) {
+                size_t value = colon + 1;
+                while (value < eol && in[value] == ' ') ++value;
+                std::string name = in.substr(pos, colon - pos);
+                headers[name] = in.substr(value, eol - value);
+                if (http::encoding::header_name_equals(name, "Content-Length")) {
+                    content_length = std::strtoull(in.c_str() + value, nullptr, 10);
+                }
+            }
+            pos = eol + 2;
+        }
+        sink.begin(status, std::move(headers));
+
+        // Body already buffered with the headers
+        size_t buffered = std::min(in.size() - (header_end + 4), content_length);
+        sink.write(in.data() + header_end + 4, buffered);
+        in.erase(0, header_end + 4 + buffered);
+        size_t remaining = content_length - buffered;
+
+        // The rest goes to the sink straight from each recv()
+        char chunk[16 * 1024];
+        while (remaining > 0) {
+            ssize_t n = ::recv(connection.fd, chunk, sizeof(chunk), 0);
+            if (n <= 0) return false;
+            size_t used = std::min(static_cast<size_t>(n), remaining);
+            sink.write(chunk, used);
+            remaining -= used;
+            if (used < static_cast<size_t>(n)) in.append(chunk + used, static_cast<size_t>(n) - used);
+        }
+        return true;
+    }
+
+    unsigned short port_;
+};
+
+} // namespace bench
+
+#endif // CPP_HTTP_CLIENT_BENCHMARKS_LOOPBACK_TRANSPORT_HPP
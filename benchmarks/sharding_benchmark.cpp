@@ -0,0 +1,129 @@
+#include "cpp_http_client/ShardedRuntime.hpp"
+#include "cpp_http_client/ThreadPool.hpp"
+#include "cpp_http_client/Request.hpp"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <memory>
+#include <cstdlib> // For std::atoi
+
+// Scaling benchmark for the executors behind Client::async_*. For 1..N cores it runs closed
+// loops of mock requests (each completion submits the next request) and reports completed
+// requests per second for:
+//   pool        - one utils::ThreadPool shared by all workers (ExecutionMode::SharedPool)
+//   shards      - utils::ShardedRuntime, each loop resubmitting to its own shard
+//   shards+hop  - ShardedRuntime where every request hands the next one to the neighbouring
+//                 shard, exercising the SPSC cross-shard queues
+
+namespace {
+
+struct alignas(64) Counter {
+    std::atomic<uint64_t> value{0};
+};
+
+using Clock = std::chrono::steady_clock;
+
+// Representative per-request CPU work: build a request and run it through the mock transport
+// (the /ok endpoint does not sleep).
+void do_request() {
+    http::Request request;
+    request.url("http://example.com/ok").method("GET").header("X-Bench", "1");
+    http::Response response = request.send();
+    if (response.status_code() != http::HTTP_STATUS_OK) std::abort();
+}
+
+struct PoolLoop {
+    http::utils::ThreadPool* pool;
+    Counter* counter;
+    Clock::time_point deadline;
+
+    void operator()() const {
+        do_request();
+        counter->value.fetch_add(1, std::memory_order_relaxed);
+        if (Clock::now() < deadline) pool->enqueue(*this);
+    }
+};
+
+struct ShardLoop {
+    http::utils::ShardedRuntime* runtime;
+    Counter* counter;
+    Clock::time_point deadline;
+    bool hop;
+
+    void operator()() const {
+        do_request();
+        counter->value.fetch_add(1, std::memory_order_relaxed);
+        if (Clock::now() >= deadline) return;
+        if (hop) {
+            runtime->submit_to(http::utils::Shard::current()->index() + 1, *this);
+        } else {
+            runtime->submit(*this); // Stays on the current shard
+        }
+    }
+};
+
+uint64_t total(const std::vector<Counter>& counters) {
+    uint64_t sum = 0;
+    for (const auto& c : counters) sum += c.value.load();
+    return sum;
+}
+
+double run_pool(size_t threads, size_t loops_per_thread, std::chrono::milliseconds duration) {
+    std::vector<Counter> counters(threads * loops_per_thread);
+    {
+        http::utils::ThreadPool pool(threads);
+        Clock::time_point deadline = Clock::now() + duration;
+        for (auto& counter : counters) pool.enqueue(PoolLoop{&pool, &counter, deadline});
+        std::this_thread::sleep_until(deadline);
+    }
+    return total(counters) / (duration.count() / 1000.0);
+}
+
+double run_shards(size_t shards, size_t loops_per_shard, std::chrono::milliseconds duration, bool hop) {
+    std::vector<Counter> counters(shards * loops_per_shard);
+    {
+        http::utils::ShardedRuntime runtime(shards);
+        Clock::time_point deadline = Clock::now() + duration;
+        for (size_t i = 0; i < counters.size(); ++i) {
+            runtime.submit_to(i % shards, ShardLoop{&runtime, &counters[i], deadline, hop});
+        }
+        std::this_thread::sleep_until(deadline);
+    }
+    return total(counters) / (duration.count() / 1000.0);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    // Usage: ShardingBenchmark [max_cores] [duration_ms] [loops_per_core]
+    size_t hw = std::thread::hardware_concurrency();
+    size_t max_cores = argc > 1 ? static_cast<size_t>(std::atoi(argv[1])) : 0;
+    if (max_cores == 0) max_cores = hw ? hw : 2;
+    std::chrono::milliseconds duration(argc > 2 ? std::atoi(argv[2]) : 1000);
+    size_t loops = argc > 3 ? static_cast<size_t>(std::atoi(argv[3])) : 16;
+
+    std::cout << "Closed-loop mock requests, " << loops << " loops per core, "
+              << duration.count() << " ms per run" << std::endl;
+    std::cout << std::setw(6) << "cores" << std::setw(14) << "pool req/s" << std::setw(14) << "shards req/s"
+              << std::setw(10) << "speedup" << std::setw(14) << "hop req/s" << std::endl;
+
+    double shard_baseline = 0;
+    std::vector<size_t> core_counts;
+    for (size_t n = 1; n < max_cores; n *= 2) core_counts.push_back(n);
+    core_counts.push_back(max_cores);
+
+    for (size_t n : core_counts) {
+        double pool = run_pool(n, loops, duration);
+        double shards = run_shards(n, loops, duration, false);
+        double hop = run_shards(n, loops, duration, true);
+        if (n == 1) shard_baseline = shards;
+        std::cout << std::setw(6) << n << std::fixed << std::setprecision(0)
+                  << std::setw(14) << pool << std::setw(14) << shards
+                  << std::setw(9) << std::setprecision(2) << (shard_baseline > 0 ? shards / shard_baseline : 0.0) << "x"
+                  << std::setw(14) << std::setprecision(0) << hop << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,28 @@
+#ifndef CPP_HTTP_CLIENT_BENCHMARKS_SOCKET_IO_HPP
+#define CPP_HTTP_CLIENT_BENCHMARKS_SOCKET_IO_HPP
+
+// Blocking socket helpers shared by the loopback server and transport.
+
+#include <string>
+#include <cerrno>
+
+#include <sys/socket.h>
+
+namespace bench {
+
+// Writes all of 'data'. Returns false if the peer is gone; MSG_NOSIGNAL turns a reset into an
+// error instead of SIGPIPE.
+inline bool send_all(int fd, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        sent += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+} // namespace bench
+
+#endif // CPP_HTTP_CLIENT_BENCHMARKS_SOCKET_IO_HPP
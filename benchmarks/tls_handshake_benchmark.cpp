@@ -0,0 +1,252 @@
+#include "cpp_http_client/TlsContext.hpp"
+#include "cpp_http_client/Request.hpp"
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <future>
+#include <cstdlib> // For std::atoi
+
+// Loopback TLS handshake benchmark. Starts an in-process TLS 1.3 server with a freshly
+// generated self-signed certificate, then measures full handshakes (empty session cache),
+// resumed handshakes with 0-RTT for an idempotent GET, and a reconnect burst driven through
+// TlsConnector's handshake pool. A second server capped at TLS 1.2 checks that session IDs /
+// tickets stay reusable across consecutive resumptions.
+
+#ifndef CPP_HTTP_CLIENT_WITH_OPENSSL
+
+int main() {
+    std::cout << "TlsHandshakeBenchmark: built without OpenSSL, nothing to measure." << std::endl;
+    return 0;
+}
+
+#else
+
+#include <openssl/evp.h>
+#include <openssl/ec.h>
+#include <arpa/inet.h>
+
+namespace {
+
+struct SelfSigned {
+    EVP_PKEY* key = nullptr;
+    X509* cert = nullptr;
+    std::string cert_pem;
+};
+
+SelfSigned make_self_signed(const char* common_name) {
+    SelfSigned out;
+    EVP_PKEY_CTX* kctx = EVP_PKEY_CTX_new_id(EVP_PKEY_EC, nullptr);
+    if (!kctx || EVP_PKEY_keygen_init(kctx) != 1 ||
+        EVP_PKEY_CTX_set_ec_paramgen_curve_nid(kctx, NID_X9_62_prime256v1) != 1 ||
+        EVP_PKEY_keygen(kctx, &out.key) != 1) {
+        throw http::tls::openssl_error("EC key generation failed");
+    }
+    EVP_PKEY_CTX_free(kctx);
+
+    out.cert = X509_new();
+    X509_set_version(out.cert, 2);
+    ASN1_INTEGER_set(X509_get_serialNumber(out.cert), 1);
+    X509_gmtime_adj(X509_getm_notBefore(out.cert), 0);
+    X509_gmtime_adj(X509_getm_notAfter(out.cert), 24 * 60 * 60);
+    X509_set_pubkey(out.cert, out.key);
+    X509_NAME* name = X509_get_subject_name(out.cert);
+    X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC, reinterpret_cast<const unsigned char*>(common_name), -1, -1, 0);
+    X509_set_issuer_name(out.cert, name);
+    if (X509_sign(out.cert, out.key, EVP_sha256()) == 0) throw http::tls::openssl_error("X509_sign failed");
+
+    BIO* bio = BIO_new(BIO_s_mem());
+    PEM_write_bio_X509(bio, out.cert);
+    char* data = nullptr;
+    long len = BIO_get_mem_data(bio, &data);
+    out.cert_pem.assign(data, static_cast<size_t>(len));
+    BIO_free(bio);
+    return out;
+}
+
+// Minimal TLS server: one connection at a time per worker, reads (early) request data until the
+// end of the headers and answers with a fixed 200 response.
+class LoopbackTlsServer {
+public:
+    // 'max_version' == 0 allows the highest version OpenSSL supports
+    LoopbackTlsServer(const SelfSigned& identity, int workers, int max_version = 0) : stop_(false) {
+        ctx_ = SSL_CTX_new(TLS_server_method());
+        SSL_CTX_set_min_proto_version(ctx_, TLS1_2_VERSION);
+        SSL_CTX_set_max_proto_version(ctx_, max_version);
+        SSL_CTX_use_certificate(ctx_, identity.cert);
+        SSL_CTX_use_PrivateKey(ctx_, identity.key);
+        SSL_CTX_set_max_early_data(ctx_, 16 * 1024);
+
+        listen_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+        int one = 1;
+        setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        sockaddr_in addr = sockaddr_in();
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = 0;
+        if (::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || ::listen(listen_fd_, 512) != 0) {
+            throw std::runtime_error("Failed to listen on loopback");
+        }
+        socklen_t len = sizeof(addr);
+        getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &len);
+        port_ = ntohs(addr.sin_port);
+
+        for (int i = 0; i < workers; ++i) threads_.emplace_back([this] { serve(); });
+    }
+
+    ~LoopbackTlsServer() {
+        stop_ = true;
+        ::shutdown(listen_fd_, SHUT_RDWR);
+        ::close(listen_fd_);
+        for (auto& t : threads_) t.join();
+        SSL_CTX_free(ctx_);
+    }
+
+    unsigned short port() const { return port_; }
+
+private:
+    void serve() {
+        while (!stop_) {
+            int fd = ::accept(listen_fd_, nullptr, nullptr);
+            if (fd < 0) continue;
+            handle(fd);
+        }
+    }
+
+    void handle(int fd) {
+        SSL* ssl = SSL_new(ctx_);
+        BIO* bio = http::tls::new_socket_bio(fd);
+        SSL_set_bio(ssl, bio, bio);
+        std::string request;
+        char buf[4096];
+        size_t n = 0;
+        bool ok = true;
+        for (;;) {
+            int rc = SSL_read_early_data(ssl, buf, sizeof(buf), &n);
+            if (rc == SSL_READ_EARLY_DATA_ERROR) { ok = false; break; }
+            request.append(buf, n);
+            if (rc == SSL_READ_EARLY_DATA_FINISH) break;
+        }
+        if (ok && SSL_accept(ssl) != 1) ok = false;
+        while (ok && request.find("\r\n\r\n") == std::string::npos) {
+            if (SSL_read_ex(ssl, buf, sizeof(buf), &n) != 1) ok = false;
+            else request.append(buf, n);
+        }
+        if (ok) {
+            static const std::string response = "HTTP/1.1 200 OK\r\nContent-Length: 2\r\nConnection: close\r\n\r\nok";
+            size_t written = 0;
+            SSL_write_ex(ssl, response.data(), response.size(), &written);
+            SSL_shutdown(ssl);
+        }
+        ERR_clear_error();
+        SSL_free(ssl);
+        ::close(fd);
+    }
+
+    SSL_CTX* ctx_;
+    int listen_fd_;
+    unsigned short port_;
+    std::atomic<bool> stop_;
+    std::vector<std::thread> threads_;
+};
+
+std::string serialize_get(const http::Request& request) {
+    return "GET " + request.get_path() + " HTTP/1.1\r\nHost: " + request.get_authority() + "\r\nConnection: close\r\n\r\n";
+}
+
+// One request/response exchange; reading the response also processes the session tickets the
+// server sends after the handshake.
+void run_exchange(http::tls::TlsConnector& connector, const http::Request& request) {
+    std::string wire = serialize_get(request);
+    auto connection = connector.async_connect(request, request.is_idempotent() ? wire : std::string()).get();
+    if (!request.is_idempotent()) connection->write(wire.data(), wire.size());
+    char buf[1024];
+    std::string response;
+    while (size_t n = connection->read(buf, sizeof(buf))) response.append(buf, n);
+    if (response.compare(0, 12, "HTTP/1.1 200") != 0) throw std::runtime_error("Unexpected response: " + response);
+}
+
+void print_phase(const char* name, const http::tls::TlsStats& before, const http::tls::TlsStats& after) {
+    uint64_t full = after.full_handshakes - before.full_handshakes;
+    uint64_t resumed = after.resumed_handshakes - before.resumed_handshakes;
+    auto full_ns = (after.full_handshake_time - before.full_handshake_time).count();
+    auto resumed_ns = (after.resumed_handshake_time - before.resumed_handshake_time).count();
+    std::cout << std::left << std::setw(22) << name << std::right
+              << std::setw(8) << full << std::setw(10) << std::fixed << std::setprecision(3)
+              << (full ? full_ns / 1e6 / full : 0.0)
+              << std::setw(10) << resumed << std::setw(12) << (resumed ? resumed_ns / 1e6 / resumed : 0.0)
+              << std::setw(10) << std::setprecision(1)
+              << (full + resumed ? 100.0 * resumed / (full + resumed) : 0.0) << "%"
+              << std::setw(8) << (after.early_data_accepted - before.early_data_accepted) << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    // Usage: TlsHandshakeBenchmark [connections_per_phase] [burst_concurrency]
+    int connections = argc > 1 ? std::atoi(argv[1]) : 200;
+    int burst = argc > 2 ? std::atoi(argv[2]) : 32;
+
+    SelfSigned identity = make_self_signed("localhost");
+    LoopbackTlsServer server(identity, 4);
+    LoopbackTlsServer server12(identity, 4, TLS1_2_VERSION);
+
+    http::tls::TlsContext context;
+    context.trust_pem(identity.cert_pem);
+    http::tls::TlsConnector connector(context, std::thread::hardware_concurrency());
+
+    http::Request request;
+    request.url("https://localhost:" + std::to_string(server.port()) + "/bench").method("GET");
+
+    http::Request request12;
+    request12.url("https://localhost:" + std::to_string(server12.port()) + "/bench").method("GET");
+
+    std::cout << "Loopback TLS server on port " << server.port() << " (TLS 1.2: " << server12.port() << ")" << ", " << connections << " connections per phase" << std::endl;
+    std::cout << std::left << std::setw(22) << "phase" << std::right << std::setw(8) << "full" << std::setw(10) << "ms/full"
+              << std::setw(10) << "resumed" << std::setw(12) << "ms/resumed" << std::setw(11) << "resume"
+              << std::setw(8) << "0-RTT" << std::endl;
+
+    // Cold: forget every session before connecting, so each handshake is a full one
+    auto before = context.stats();
+    for (int i = 0; i < connections; ++i) {
+        context.sessions().clear();
+        run_exchange(connector, request);
+    }
+    print_phase("cold (no cache)", before, context.stats());
+
+    // Warm: tickets from the previous connection are reused, with the GET sent as 0-RTT
+    before = context.stats();
+    for (int i = 0; i < connections; ++i) run_exchange(connector, request);
+    print_phase("warm (resumption)", before, context.stats());
+
+    // TLS 1.2: one full handshake, then the same session should resume every time
+    before = context.stats();
+    for (int i = 0; i < connections; ++i) run_exchange(connector, request12);
+    print_phase("warm TLS 1.2", before, context.stats());
+
+    // Reconnect burst: many concurrent handshakes go through the connector's pool
+    before = context.stats();
+    auto start = std::chrono::steady_clock::now();
+    for (int done = 0; done < connections; done += burst) {
+        std::vector<std::future<void>> inflight;
+        for (int i = 0; i < burst && done + i < connections; ++i) {
+            inflight.push_back(std::async(std::launch::async, [&] { run_exchange(connector, request); }));
+        }
+        for (auto& f : inflight) f.get();
+    }
+    double burst_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    print_phase("reconnect burst", before, context.stats());
+    std::cout << "Burst throughput: " << std::setprecision(0) << connections / burst_seconds << " connections/s" << std::endl;
+
+    auto total = context.stats();
+    std::cout << "Overall resumption rate: " << std::setprecision(1) << 100.0 * total.resumption_rate() << "%, "
+              << "0-RTT accepted " << total.early_data_accepted << ", rejected " << total.early_data_rejected << std::endl;
+
+    X509_free(identity.cert);
+    EVP_PKEY_free(identity.key);
+    return 0;
+}
+
+#endif // CPP_HTTP_CLIENT_WITH_OPENSSL
@@ -225,5 +225,39 @@ int main() {
         std::cerr << "Sync Timeout Zero Exception: " << e.what() << std::endl;
     }
 
+    std::cout << "\n========= Compressed Response Examples =========\n" << std::endl;
+
+    // Accept-Encoding is negotiated automatically; the body arrives decoded
+    std::cout << "Testing GET to: http://example.com/compressed (automatic decompression)" << std::endl;
+    try {
+        http::Response resp_compressed = http::Client::get("http://example.com/compressed");
+        std::cout << "Compressed Status: " << resp_compressed.status_code() << std::endl;
+        std::cout << "Compressed Body Size (decoded): " << resp_compressed.body().size() << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Compressed Exception: " << e.what() << std::endl;
+    }
+
+    std::cout << "\n-----------------------------------\n" << std::endl;
+
+    // Opting out keeps the encoded body and its Content-Encoding header
+    std::cout << "Testing GET to: http://example.com/compressed with decompression disabled" << std::endl;
+    try {
+        http::Request req_raw;
+        req_raw.url("http://example.com/compressed")
+               .method("GET")
+               .header("Accept-Encoding", "gzip")
+               .decompress(false);
+
+        http::Response resp_raw = req_raw.send();
+        std::cout << "Raw Status: " << resp_raw.status_code() << std::endl;
+        std::cout << "Raw Body Size (encoded): " << resp_raw.body().size() << std::endl;
+        std::cout << "Raw Headers:" << std::endl;
+        for(const auto& pair : resp_raw.headers()) {
+            std::cout << "  " << pair.first << ": " << pair.second << std::endl;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Raw Exception: " << e.what() << std::endl;
+    }
+
     return 0;
 }
@@ -179,6 +179,56 @@ int main() {
     }
 
 
+    std::cout << "\n========= Priorities and Deadlines =========\n" << std::endl;
+
+    // A bulk upload queued as Low priority does not hold back the interactive High-priority GET
+    http::Request bulk_upload;
+    bulk_upload.url("http://example.com/submit")
+               .method("POST")
+               .body(R"({"batch":"nightly_export"})")
+               .priority(http::utils::Priority::Low);
+    auto future_bulk = http::Client::async_send(bulk_upload);
+
+    http::Request interactive_get;
+    interactive_get.url("http://example.com/ok")
+                   .method("GET")
+                   .priority(http::utils::Priority::High)
+                   .deadline(std::chrono::steady_clock::now() + std::chrono::milliseconds(500));
+    auto future_interactive = http::Client::async_send(interactive_get);
+
+    // async_get/async_post take the same settings directly
+    http::utils::TaskOptions low_priority;
+    low_priority.priority = http::utils::Priority::Low;
+    auto future_bulk_post = http::Client::async_post("http://example.com/submit", R"({"batch":"archive"})", low_priority);
+
+    process_response("http://example.com/ok (High priority)", future_interactive);
+    process_response("http://example.com/submit (Low priority)", future_bulk);
+    process_response("http://example.com/submit (Low priority async_post)", future_bulk_post);
+
+    // A request whose deadline has already passed is dropped instead of being sent
+    http::Request stale_request;
+    stale_request.url("http://example.com/ok")
+                 .method("GET")
+                 .deadline(std::chrono::steady_clock::now() - std::chrono::milliseconds(1));
+    auto future_stale = http::Client::async_send(stale_request);
+    process_response("http://example.com/ok (expired deadline)", future_stale);
+
+    std::cout << "\n========= Per-Core Sharded Runtime =========\n" << std::endl;
+
+    // Switch async_* calls to the shard-per-core executor. Calls from this (non-shard) thread
+    // are spread round-robin over the shards; each shard sends one request at a time.
+    http::Client::execution_mode(http::ExecutionMode::PerCoreShards);
+    std::cout << "Sharded runtime with " << http::Client::get_sharded_runtime().size() << " shard(s)" << std::endl;
+
+    auto future_sharded_get = http::Client::async_get("http://example.com/ok");
+    process_response("http://example.com/ok (sharded)", future_sharded_get);
+
+    std::string sharded_post_body = R"({"data":"sharded_payload"})";
+    auto future_sharded_post = http::Client::async_post("http://example.com/submit", sharded_post_body);
+    process_response("http://example.com/submit (sharded POST)", future_sharded_post);
+
+    http::Client::execution_mode(http::ExecutionMode::SharedPool);
+
     std::cout << "\nAll async GET, POST, custom header, and timeout examples completed." << std::endl;
 
     return 0;
@@ -4,12 +4,22 @@
 #include "Request.hpp"
 #include "Response.hpp"
 #include "ThreadPool.hpp" // Added ThreadPool
+#include "ShardedRuntime.hpp"
 #include <string>
+#include <atomic>
 #include <future>    // Added for std::future
 #include <functional> // Added for std::bind or lambdas if needed directly here
 
 namespace http {
 
+// Where Client's async_* calls run.
+enum class ExecutionMode {
+    SharedPool,   // One global utils::ThreadPool; any worker may pick up any request (default)
+    PerCoreShards // utils::ShardedRuntime; a request runs on the submitting shard, or round-robin
+                  // from other threads. Each shard sends one request at a time, so at most
+                  // get_sharded_runtime().size() requests are in flight.
+};
+
 class Client {
 public:
     // Get the default thread pool instance
@@ -21,6 +31,23 @@ public:
         return default_pool;
     }
 
+    // Get the sharded runtime instance (one shard per hardware thread), created on first use
+    static utils::ShardedRuntime& get_sharded_runtime() {
+        static utils::ShardedRuntime default_runtime(0);
+        return default_runtime;
+    }
+
+    // Select the executor used by async_get/async_post/async_send. Requests already queued are
+    // unaffected. PerCoreShards pays off when requests are issued from shard threads (chained
+    // work stays on one core); from application threads it only adds a locked inbox hop.
+    static void execution_mode(ExecutionMode mode) {
+        execution_mode_slot().store(mode);
+    }
+
+    static ExecutionMode execution_mode() {
+        return execution_mode_slot().load();
+    }
+
     // Static method to perform a synchronous GET request
     static Response get(const std::string& url) {
         Request request;
@@ -31,6 +58,11 @@ public:
 
     // Static method to perform an asynchronous GET request
     static std::future<Response> async_get(const std::string& url) {
+        return async_get(url, utils::TaskOptions());
+    }
+
+    // Asynchronous GET with an explicit priority class and/or deadline (see async_send)
+    static std::future<Response> async_get(const std::string& url, const utils::TaskOptions& options) {
         // The task to be executed in the thread pool.
         // It captures 'url' by value to ensure it's valid when the task runs.
         // It needs to return a Response object.
@@ -42,9 +74,9 @@ public:
             return request.send(); // Calls the mock send
         };
 
-        // Enqueue the task into our thread pool.
-        // The ThreadPool's enqueue method should return a std::future<Response>.
-        return get_thread_pool().enqueue(task);
+        // Enqueue the task into the active executor.
+        // Both executors return a std::future<Response>.
+        return dispatch(task, options);
     }
 
     // Static method to perform a synchronous POST request
@@ -58,6 +90,13 @@ public:
 
     // Static method to perform an asynchronous POST request
     static std::future<Response> async_post(const std::string& url, const std::string& body) {
+        return async_post(url, body, utils::TaskOptions());
+    }
+
+    // Asynchronous POST with an explicit priority class and/or deadline, e.g. Priority::Low for
+    // bulk uploads so they do not delay interactive requests
+    static std::future<Response> async_post(const std::string& url, const std::string& body,
+                                            const utils::TaskOptions& options) {
         // The task to be executed in the thread pool.
         // Captures 'url' and 'body' by value.
         auto task = [url, body]() -> Response {
@@ -67,7 +106,22 @@ public:
             request.body(body);
             return request.send(); // Calls the mock send
         };
-        return get_thread_pool().enqueue(task);
+        return dispatch(task, options);
+    }
+
+    // Asynchronously send a fully built Request. Its priority and deadline are passed to the
+    // executor: higher classes are served first, and a request whose deadline passes while it
+    // is queued is dropped (the future throws utils::DeadlineExceeded). In PerCoreShards mode
+    // requests run in arrival order and only the deadline applies.
+    static std::future<Response> async_send(const Request& request) {
+        utils::TaskOptions options;
+        options.priority = request.get_priority();
+        options.deadline = request.get_deadline();
+        // Copied into a non-const capture, since send() fills in negotiated headers
+        auto task = [req = request]() mutable -> Response {
+            return req.send();
+        };
+        return dispatch(task, options);
     }
 
     // Potentially other methods like put, delete could be added here later
@@ -75,6 +129,24 @@ public:
     // static std::future<Response> async_put(const std::string& url, const std::string& body);
     // static Response del(const std::string& url); // 'delete' is a keyword
     // static std::future<Response> async_del(const std::string& url);
+
+private:
+    static std::atomic<ExecutionMode>& execution_mode_slot() {
+        static std::atomic<ExecutionMode> mode(ExecutionMode::SharedPool);
+        return mode;
+    }
+
+    template<class F>
+    static std::future<Response> dispatch(F&& task, const utils::TaskOptions& options = utils::TaskOptions()) {
+        if (execution_mode() == ExecutionMode::PerCoreShards) {
+            auto deadline = options.deadline;
+            return get_sharded_runtime().submit([deadline, task]() mutable -> Response {
+                if (deadline && std::chrono::steady_clock::now() > *deadline) throw utils::DeadlineExceeded();
+                return task();
+            });
+        }
+        return get_thread_pool().enqueue_with(options, std::forward<F>(task));
+    }
 };
 
 } // namespace http
@@ -0,0 +1,472 @@
+#ifndef CPP_HTTP_CLIENT_CONTENTDECODER_HPP
+#define CPP_HTTP_CLIENT_CONTENTDECODER_HPP
+
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <cctype>    // For std::tolower
+#include <cstddef>   // For size_t
+#include <stdexcept> // For std::runtime_error
+
+// Codecs are opt-in: the build defines these when the matching library is found
+// (see the CPP_HTTP_CLIENT_WITH_ZLIB / CPP_HTTP_CLIENT_WITH_ZSTD options in CMakeLists.txt).
+#ifdef CPP_HTTP_CLIENT_WITH_ZLIB
+#include <zlib.h>
+#endif
+#ifdef CPP_HTTP_CLIENT_WITH_ZSTD
+#include <zstd.h>
+#endif
+
+namespace http {
+namespace encoding { // Content-Encoding negotiation and streaming decompression
+
+enum class ContentEncoding {
+    Identity,
+    Gzip,
+    Deflate,
+    Zstd,
+    Unsupported
+};
+
+// Size of the scratch window each decompressor inflates into before appending to the output.
+const size_t DECODE_CHUNK_SIZE = 16 * 1024;
+
+// Default cap on a decoded body, so a small compressed body cannot expand without bound.
+const size_t DEFAULT_MAX_DECODED_SIZE = 64 * 1024 * 1024;
+
+class BodyTooLarge : public std::runtime_error {
+public:
+    explicit BodyTooLarge(size_t limit)
+        : std::runtime_error("Decoded body exceeds the limit of " + std::to_string(limit) + " bytes") {}
+};
+
+// Maps a Content-Encoding token (case-insensitive) to a ContentEncoding.
+inline ContentEncoding parse_content_encoding(const std::string& value) {
+    std::string token;
+    for (char c : value) {
+        if (c != ' ' && c != '\t') token += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    if (token.empty() || token == "identity") return ContentEncoding::Identity;
+    if (token == "gzip" || token == "x-gzip") return ContentEncoding::Gzip;
+    if (token == "deflate") return ContentEncoding::Deflate;
+    if (token == "zstd") return ContentEncoding::Zstd;
+    return ContentEncoding::Unsupported;
+}
+
+inline bool is_supported(ContentEncoding enc) {
+    switch (enc) {
+        case ContentEncoding::Identity: return true;
+#ifdef CPP_HTTP_CLIENT_WITH_ZLIB
+        case ContentEncoding::Gzip:
+        case ContentEncoding::Deflate: return true;
+#endif
+#ifdef CPP_HTTP_CLIENT_WITH_ZSTD
+        case ContentEncoding::Zstd: return true;
+#endif
+        default: return false;
+    }
+}
+
+// Value sent in the Accept-Encoding request header: only the codecs compiled in are advertised,
+// so a server never picks an encoding we cannot decode.
+inline const std::string& accept_encoding_value() {
+    static const std::string value = [] {
+        std::string v;
+#ifdef CPP_HTTP_CLIENT_WITH_ZSTD
+        v += "zstd, ";
+#endif
+#ifdef CPP_HTTP_CLIENT_WITH_ZLIB
+        v += "gzip, deflate, ";
+#endif
+        v += "identity";
+        return v;
+    }();
+    return value;
+}
+
+// HTTP header names are case-insensitive.
+inline bool header_name_equals(const std::string& a, const std::string& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (std::tolower(static_cast<unsigned char>(a[i])) != std::tolower(static_cast<unsigned char>(b[i]))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Case-insensitive header lookup; returns nullptr if the header is absent.
+inline const std::string* find_header(const std::map<std::string, std::string>& headers, const std::string& name) {
+    for (const auto& pair : headers) {
+        if (header_name_equals(pair.first, name)) return &pair.second;
+    }
+    return nullptr;
+}
+
+// Incremental decompressor. decode() may be called any number of times with consecutive
+// pieces of the encoded body; decoded bytes are appended to 'out'.
+class Decompressor {
+public:
+    virtual ~Decompressor() = default;
+
+    // Prepares the context for a new body without releasing its internal buffers.
+    virtual void reset() = 0;
+    // Throws BodyTooLarge once more than the output limit has been decoded since reset().
+    virtual void decode(const char* data, size_t len, std::string& out) = 0;
+    // Throws if the stream ended before the codec saw a complete frame.
+    virtual void finish() = 0;
+    virtual ContentEncoding encoding() const = 0;
+
+    // Maximum bytes decode() may produce for the current body; restarts the count.
+    void limit_output(size_t max_bytes) {
+        max_output_ = max_bytes;
+        produced_ = 0;
+    }
+
+protected:
+    // Called by decode() after each window of output
+    void produced(size_t n) {
+        produced_ += n;
+        if (produced_ > max_output_) throw BodyTooLarge(max_output_);
+    }
+
+private:
+    size_t max_output_ = DEFAULT_MAX_DECODED_SIZE;
+    size_t produced_ = 0;
+};
+
+#ifdef CPP_HTTP_CLIENT_WITH_ZLIB
+class ZlibDecompressor : public Decompressor {
+public:
+    explicit ZlibDecompressor(ContentEncoding enc) : encoding_(enc), done_(false), raw_(false), seen_input_(false) {
+        stream_ = z_stream();
+        if (inflateInit2(&stream_, window_bits()) != Z_OK) {
+            throw std::runtime_error("inflateInit2 failed");
+        }
+    }
+
+    ~ZlibDecompressor() override {
+        inflateEnd(&stream_);
+    }
+
+    ZlibDecompressor(const ZlibDecompressor&) = delete;
+    ZlibDecompressor& operator=(const ZlibDecompressor&) = delete;
+
+    void reset() override {
+        done_ = false;
+        seen_input_ = false;
+        if (raw_) {
+            // A previous body was raw deflate; go back to expecting a zlib wrapper.
+            raw_ = false;
+            inflateReset2(&stream_, window_bits());
+        } else {
+            inflateReset(&stream_);
+        }
+    }
+
+    void decode(const char* data, size_t len, std::string& out) override {
+        if (len == 0) return;
+        if (done_) throw std::runtime_error("Trailing data after end of compressed body");
+
+        // Some servers send "deflate" without the zlib header (RFC 1951 instead of RFC 1950).
+        // Sniff the first byte and switch to raw inflate if it is not a zlib header.
+        if (!seen_input_ && encoding_ == ContentEncoding::Deflate &&
+            (static_cast<unsigned char>(data[0]) & 0x0F) != 0x08) {
+            raw_ = true;
+            inflateReset2(&stream_, -MAX_WBITS);
+        }
+        seen_input_ = true;
+
+        stream_.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+        stream_.avail_in = static_cast<uInt>(len);
+        // Keep going while input remains or the last window filled up, since inflate may be
+        // holding decoded bytes it could not yet write.
+        for (;;) {
+            size_t old_size = out.size();
+            out.resize(old_size + DECODE_CHUNK_SIZE);
+            stream_.next_out = reinterpret_cast<Bytef*>(&out[old_size]);
+            stream_.avail_out = static_cast<uInt>(DECODE_CHUNK_SIZE);
+
+            int rc = inflate(&stream_, Z_NO_FLUSH);
+            out.resize(old_size + (DECODE_CHUNK_SIZE - stream_.avail_out));
+            produced(DECODE_CHUNK_SIZE - stream_.avail_out);
+            if (rc == Z_STREAM_END) {
+                done_ = true;
+                if (stream_.avail_in > 0) throw std::runtime_error("Trailing data after end of compressed body");
+                break;
+            }
+            if (rc != Z_OK && rc != Z_BUF_ERROR) {
+                throw std::runtime_error(std::string("inflate failed: ") + (stream_.msg ? stream_.msg : "corrupt data"));
+            }
+            if (stream_.avail_out != 0) break; // All input consumed, nothing pending
+        }
+    }
+
+    void finish() override {
+        if (seen_input_ && !done_) throw std::runtime_error("Truncated compressed body");
+    }
+
+    ContentEncoding encoding() const override { return encoding_; }
+
+private:
+    int window_bits() const {
+        // 15 + 16 accepts only a gzip wrapper; 15 expects the zlib wrapper used by "deflate".
+        return encoding_ == ContentEncoding::Gzip ? MAX_WBITS + 16 : MAX_WBITS;
+    }
+
+    ContentEncoding encoding_;
+    z_stream stream_;
+    bool done_;
+    bool raw_;
+    bool seen_input_;
+};
+#endif // CPP_HTTP_CLIENT_WITH_ZLIB
+
+#ifdef CPP_HTTP_CLIENT_WITH_ZSTD
+class ZstdDecompressor : public Decompressor {
+public:
+    ZstdDecompressor() : ctx_(ZSTD_createDCtx()), frame_open_(false) {
+        if (!ctx_) throw std::runtime_error("ZSTD_createDCtx failed");
+    }
+
+    ~ZstdDecompressor() override {
+        ZSTD_freeDCtx(ctx_);
+    }
+
+    ZstdDecompressor(const ZstdDecompressor&) = delete;
+    ZstdDecompressor& operator=(const ZstdDecompressor&) = delete;
+
+    void reset() override {
+        ZSTD_DCtx_reset(ctx_, ZSTD_reset_session_only);
+        frame_open_ = false;
+    }
+
+    void decode(const char* data, size_t len, std::string& out) override {
+        ZSTD_inBuffer input = {data, len, 0};
+        for (;;) {
+            size_t old_size = out.size();
+            out.resize(old_size + DECODE_CHUNK_SIZE);
+            ZSTD_outBuffer output = {&out[old_size], DECODE_CHUNK_SIZE, 0};
+
+            size_t consumed_before = input.pos;
+            size_t rc = ZSTD_decompressStream(ctx_, &output, &input);
+            out.resize(old_size + output.pos);
+            produced(output.pos);
+            if (ZSTD_isError(rc)) {
+                throw std::runtime_error(std::string("ZSTD_decompressStream failed: ") + ZSTD_getErrorName(rc));
+            }
+            // rc == 0 means a frame was fully decoded and flushed; a body may hold several frames.
+            // A call that made no progress just reports "expecting the next frame", so ignore it.
+            if (input.pos != consumed_before || output.pos != 0) frame_open_ = rc != 0;
+            if (input.pos == input.size && output.pos < output.size) break;
+        }
+    }
+
+    void finish() override {
+        if (frame_open_) throw std::runtime_error("Truncated compressed body");
+    }
+
+    ContentEncoding encoding() const override { return ContentEncoding::Zstd; }
+
+private:
+    ZSTD_DCtx* ctx_;
+    bool frame_open_;
+};
+#endif // CPP_HTTP_CLIENT_WITH_ZSTD
+
+// Per-thread cache of decompressor contexts and body buffers. Creating a zlib or zstd context
+// allocates its window and tables, and a body buffer grows through several reallocations, so both
+// are reset and reused instead of rebuilt per response.
+class DecompressorPool {
+public:
+    // Returns the context to this thread's pool when it goes out of scope.
+    class Lease {
+    public:
+        Lease() = default;
+        explicit Lease(std::unique_ptr<Decompressor> d) : decompressor_(std::move(d)) {}
+        Lease(Lease&&) = default;
+        Lease& operator=(Lease&& other) {
+            release();
+            decompressor_ = std::move(other.decompressor_);
+            return *this;
+        }
+        ~Lease() { release(); }
+
+        Decompressor* operator->() const { return decompressor_.get(); }
+        Decompressor& operator*() const { return *decompressor_; }
+        explicit operator bool() const { return static_cast<bool>(decompressor_); }
+
+    private:
+        void release() {
+            if (decompressor_) DecompressorPool::local().put(std::move(decompressor_));
+        }
+
+        std::unique_ptr<Decompressor> decompressor_;
+    };
+
+    static DecompressorPool& local() {
+        thread_local DecompressorPool pool;
+        return pool;
+    }
+
+    // Throws std::runtime_error if 'enc' is not compiled in. Identity has no decompressor.
+    Lease acquire(ContentEncoding enc) {
+        auto& slot = idle_[index(enc)];
+        if (!slot.empty()) {
+            std::unique_ptr<Decompressor> d = std::move(slot.back());
+            slot.pop_back();
+            d->reset();
+            return Lease(std::move(d));
+        }
+        return Lease(create(enc));
+    }
+
+    void put(std::unique_ptr<Decompressor> d) {
+        auto& slot = idle_[index(d->encoding())];
+        if (slot.size() < MAX_IDLE_PER_ENCODING) slot.push_back(std::move(d));
+    }
+
+    // An empty buffer, with the capacity it had when last returned if one is idle.
+    std::string acquire_buffer() {
+        if (idle_buffers_.empty()) return std::string();
+        std::string buffer = std::move(idle_buffers_.back());
+        idle_buffers_.pop_back();
+        return buffer;
+    }
+
+    // Buffers that grew past MAX_RETAINED_BUFFER_CAPACITY are freed rather than kept per thread.
+    void put_buffer(std::string buffer) {
+        if (buffer.capacity() > MAX_RETAINED_BUFFER_CAPACITY || idle_buffers_.size() >= MAX_IDLE_BUFFERS) return;
+        buffer.clear();
+        idle_buffers_.push_back(std::move(buffer));
+    }
+
+private:
+    static constexpr size_t MAX_IDLE_PER_ENCODING = 4;
+    static constexpr size_t MAX_IDLE_BUFFERS = 2;
+    static constexpr size_t MAX_RETAINED_BUFFER_CAPACITY = 1024 * 1024;
+
+    static size_t index(ContentEncoding enc) {
+        switch (enc) {
+            case ContentEncoding::Gzip: return 0;
+            case ContentEncoding::Deflate: return 1;
+            case ContentEncoding::Zstd: return 2;
+            default: throw std::runtime_error("No decompressor for this Content-Encoding");
+        }
+    }
+
+    static std::unique_ptr<Decompressor> create(ContentEncoding enc) {
+        switch (enc) {
+#ifdef CPP_HTTP_CLIENT_WITH_ZLIB
+            case ContentEncoding::Gzip:
+            case ContentEncoding::Deflate: return std::unique_ptr<Decompressor>(new ZlibDecompressor(enc));
+#endif
+#ifdef CPP_HTTP_CLIENT_WITH_ZSTD
+            case ContentEncoding::Zstd: return std::unique_ptr<Decompressor>(new ZstdDecompressor());
+#endif
+            default: throw std::runtime_error("Content-Encoding not supported by this build");
+        }
+    }
+
+    std::vector<std::unique_ptr<Decompressor>> idle_[3];
+    std::vector<std::string> idle_buffers_;
+};
+
+// Decodes a response body as it arrives. feed() is called with each received piece of the
+// body; the decoded output accumulates in a buffer borrowed from this thread's DecompressorPool
+// and handed back on destruction, so steady-state decoding does not regrow it per response.
+// feed() throws BodyTooLarge once the decoded body would exceed 'max_decoded' bytes.
+class StreamingBodyDecoder {
+public:
+    explicit StreamingBodyDecoder(ContentEncoding enc, size_t max_decoded = DEFAULT_MAX_DECODED_SIZE)
+        : encoding_(enc), max_decoded_(max_decoded), identity_bytes_(0),
+          output_(DecompressorPool::local().acquire_buffer()) {
+        if (enc != ContentEncoding::Identity) {
+            decompressor_ = DecompressorPool::local().acquire(enc);
+            decompressor_->limit_output(max_decoded);
+        }
+    }
+
+    StreamingBodyDecoder(const StreamingBodyDecoder&) = delete;
+    StreamingBodyDecoder& operator=(const StreamingBodyDecoder&) = delete;
+
+    ~StreamingBodyDecoder() { DecompressorPool::local().put_buffer(std::move(output_)); }
+
+    void feed(const char* data, size_t len) {
+        if (decompressor_) {
+            decompressor_->decode(data, len, output_);
+        } else {
+            identity_bytes_ += len;
+            if (identity_bytes_ > max_decoded_) throw BodyTooLarge(max_decoded_);
+            output_.append(data, len);
+        }
+    }
+
+    void feed(const std::string& chunk) {
+        feed(chunk.data(), chunk.size());
+    }
+
+    void finish() {
+        if (decompressor_) decompressor_->finish();
+    }
+
+    ContentEncoding encoding() const { return encoding_; }
+
+    // Decoded bytes produced so far. Callers streaming to a sink can consume and clear() it
+    // between feed() calls; the buffer keeps its capacity. Copy the result out rather than
+    // moving it, or the buffer is lost to the pool.
+    std::string& output() { return output_; }
+
+private:
+    ContentEncoding encoding_;
+    size_t max_decoded_;
+    size_t identity_bytes_;
+    DecompressorPool::Lease decompressor_;
+    std::string output_;
+};
+
+// One-shot compression, used by the mock backend and benchmarks to produce encoded bodies.
+inline std::string encode(ContentEncoding enc, const std::string& input, int level = -1) {
+    (void)level; // Unused when no codec is compiled in
+    switch (enc) {
+        case ContentEncoding::Identity: return input;
+#ifdef CPP_HTTP_CLIENT_WITH_ZLIB
+        case ContentEncoding::Gzip:
+        case ContentEncoding::Deflate: {
+            z_stream stream = z_stream();
+            int bits = enc == ContentEncoding::Gzip ? MAX_WBITS + 16 : MAX_WBITS;
+            if (deflateInit2(&stream, level < 0 ? Z_DEFAULT_COMPRESSION : level, Z_DEFLATED, bits, 8,
+                             Z_DEFAULT_STRATEGY) != Z_OK) {
+                throw std::runtime_error("deflateInit2 failed");
+            }
+            std::string out(deflateBound(&stream, static_cast<uLong>(input.size())), '\0');
+            stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+            stream.avail_in = static_cast<uInt>(input.size());
+            stream.next_out = reinterpret_cast<Bytef*>(&out[0]);
+            stream.avail_out = static_cast<uInt>(out.size());
+            int rc = deflate(&stream, Z_FINISH);
+            out.resize(stream.total_out);
+            deflateEnd(&stream);
+            if (rc != Z_STREAM_END) throw std::runtime_error("deflate failed");
+            return out;
+        }
+#endif
+#ifdef CPP_HTTP_CLIENT_WITH_ZSTD
+        case ContentEncoding::Zstd: {
+            std::string out(ZSTD_compressBound(input.size()), '\0');
+            size_t n = ZSTD_compress(&out[0], out.size(), input.data(), input.size(),
+                                     level < 0 ? ZSTD_CLEVEL_DEFAULT : level);
+            if (ZSTD_isError(n)) throw std::runtime_error(std::string("ZSTD_compress failed: ") + ZSTD_getErrorName(n));
+            out.resize(n);
+            return out;
+        }
+#endif
+        default: throw std::runtime_error("Content-Encoding not supported by this build");
+    }
+}
+
+} // namespace encoding
+} // namespace http
+
+#endif // CPP_HTTP_CLIENT_CONTENTDECODER_HPP
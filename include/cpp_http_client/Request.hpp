@@ -2,12 +2,18 @@
 #define CPP_HTTP_CLIENT_REQUEST_HPP
 
 #include "Response.hpp"
+#include "ContentDecoder.hpp"
+#include "TaskOptions.hpp"
 #include <string>
 #include <stdexcept> // For std::runtime_error
+#include <algorithm> // For std::min
 #include <map>       // For headers
 #include <sstream>   // For string manipulation in mock
 #include <chrono>    // For std::chrono::milliseconds and sleep_for
 #include <thread>    // For std::this_thread::sleep_for
+#include <optional>
+#include <functional> // For the transport hook
+#include <charconv>   // For std::from_chars
 
 namespace http {
 
@@ -19,19 +25,95 @@ const int HTTP_STATUS_CREATED = 201;
 const int HTTP_STATUS_NOT_FOUND = 404;
 const int HTTP_STATUS_INTERNAL_SERVER_ERROR = 500;
 
+// Receives a response from a transport as it arrives: begin() with the status and headers,
+// then the body in whatever pieces the transport reads. When decoding is enabled and the body
+// has a supported Content-Encoding, each piece goes straight through a streaming decoder and
+// Content-Encoding/Content-Length (which describe the encoded form) are dropped from the headers.
+// A body larger than 'max_body_size' (after decoding) makes write() throw encoding::BodyTooLarge.
+// 'body_expected' is false for HEAD requests, whose Content-Length describes a body never sent.
+class ResponseSink {
+public:
+    explicit ResponseSink(bool decompress, size_t max_body_size = encoding::DEFAULT_MAX_DECODED_SIZE,
+                          bool body_expected = true)
+        : decompress_(decompress), body_expected_(body_expected), max_body_size_(max_body_size), status_code_(0) {}
+
+    // May be called again to start over, e.g. when a transport retries on a new connection.
+    void begin(int status_code, std::map<std::string, std::string> headers) {
+        status_code_ = status_code;
+        headers_ = std::move(headers);
+        encoding::ContentEncoding enc = encoding::ContentEncoding::Identity;
+        const std::string* content_encoding = encoding::find_header(headers_, "Content-Encoding");
+        if (decompress_ && content_encoding) {
+            encoding::ContentEncoding parsed = encoding::parse_content_encoding(*content_encoding);
+            if (parsed != encoding::ContentEncoding::Identity && encoding::is_supported(parsed)) enc = parsed;
+        }
+        size_t size_hint = reserve_hint(enc);
+        if (enc != encoding::ContentEncoding::Identity) {
+            for (auto it = headers_.begin(); it != headers_.end();) {
+                if (encoding::header_name_equals(it->first, "Content-Encoding") ||
+                    encoding::header_name_equals(it->first, "Content-Length")) {
+                    it = headers_.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+        decoder_.emplace(enc, max_body_size_);
+        decoder_->output().reserve(size_hint);
+    }
+
+    void write(const char* data, size_t len) {
+        if (!decoder_) throw std::runtime_error("ResponseSink::write called before begin");
+        decoder_->feed(data, len);
+    }
+
+    Response finish() {
+        if (!decoder_) throw std::runtime_error("ResponseSink::finish called before begin");
+        decoder_->finish();
+        return Response(status_code_, decoder_->output(), headers_); // Exact-size copy; the buffer is reused
+    }
+
+private:
+    // Content-Length is only a hint, and an untrusted one: the reservation is capped so a
+    // huge or bogus value cannot allocate up front, and the buffer grows past it as data arrives.
+    static constexpr size_t MAX_RESERVE_HINT = 1024 * 1024;
+
+    // Bytes to reserve for the decoded body: none when no body can follow (HEAD, 1xx, 204, 304),
+    // otherwise Content-Length (x4 for compressed bodies), capped.
+    size_t reserve_hint(encoding::ContentEncoding enc) const {
+        if (!body_expected_ || status_code_ < 200 || status_code_ == 204 || status_code_ == 304) return 0;
+        const std::string* length = encoding::find_header(headers_, "Content-Length");
+        if (!length) return 0;
+        unsigned long long value = 0;
+        if (std::from_chars(length->data(), length->data() + length->size(), value).ec != std::errc()) return 0;
+        size_t cap = std::min(MAX_RESERVE_HINT, max_body_size_);
+        if (enc != encoding::ContentEncoding::Identity) value = value > cap / 4 ? cap : value * 4;
+        return static_cast<size_t>(std::min<unsigned long long>(value, cap));
+    }
+
+    bool decompress_;
+    bool body_expected_;
+    size_t max_body_size_;
+    int status_code_;
+    std::map<std::string, std::string> headers_;
+    std::optional<encoding::StreamingBodyDecoder> decoder_;
+};
 
 class Request {
 public:
-    Request() : method_("GET"), timeout_(std::chrono::milliseconds(30000)) {} // Default 30s timeout
+    Request() : method_("GET"), timeout_(std::chrono::milliseconds(30000)), port_(80), https_(false), decompress_(true),
+                max_body_size_(encoding::DEFAULT_MAX_DECODED_SIZE) {} // Default 30s timeout
 
     Request& url(const std::string& url_str) {
         url_ = url_str;
+        https_ = false;
         if (url_.rfind("http://", 0) == 0) {
             std::string temp = url_.substr(7);
             size_t path_start = temp.find('/');
             host_ = (path_start == std::string::npos) ? temp : temp.substr(0, path_start);
             path_ = (path_start == std::string::npos) ? "/" : temp.substr(path_start);
         } else if (url_.rfind("https://", 0) == 0) {
+            https_ = true;
             std::string temp = url_.substr(8);
             size_t path_start = temp.find('/');
             host_ = (path_start == std::string::npos) ? temp : temp.substr(0, path_start);
@@ -40,9 +122,60 @@ public:
             host_ = "unknown";
             path_ = "/";
         }
+
+        // Drop any "user:password@" userinfo, then split an explicit ":port" off the authority
+        // ("[::1]:8443" keeps its brackets' contents). An invalid port makes the URL unusable,
+        // handled like an unrecognised scheme rather than by throwing.
+        port_ = https_ ? 443 : 80;
+        size_t at = host_.rfind('@');
+        if (at != std::string::npos) host_ = host_.substr(at + 1);
+        size_t colon = host_.rfind(':');
+        size_t bracket = host_.rfind(']');
+        if (colon != std::string::npos && (bracket == std::string::npos || colon > bracket)) {
+            const char* first = host_.data() + colon + 1;
+            const char* last = host_.data() + host_.size();
+            unsigned long port = 0;
+            std::from_chars_result parsed = std::from_chars(first, last, port);
+            if (first == last || parsed.ec != std::errc() || parsed.ptr != last || port == 0 || port > 65535) {
+                host_ = "unknown";
+                path_ = "/";
+                port_ = https_ ? 443 : 80;
+                return *this;
+            }
+            port_ = static_cast<unsigned short>(port);
+            host_ = host_.substr(0, colon);
+        }
+        if (host_.size() > 1 && host_.front() == '[' && host_.back() == ']') {
+            host_ = host_.substr(1, host_.size() - 2);
+        }
         return *this;
     }
 
+    const std::string& get_url() const { return url_; }
+    const std::string& get_method() const { return method_; }
+    const std::string& get_body() const { return body_; }
+    const std::map<std::string, std::string>& get_headers() const { return headers_; }
+
+    bool is_https() const { return https_; }
+    const std::string& get_host() const { return host_; }
+    unsigned short get_port() const { return port_; }
+    const std::string& get_path() const { return path_; }
+
+    // Host header value (RFC 9110 section 7.2): the host, bracketed if it is an IPv6 literal,
+    // with ":port" only when the port is not the scheme's default.
+    std::string get_authority() const {
+        std::string authority = host_.find(':') != std::string::npos ? "[" + host_ + "]" : host_;
+        if (port_ != (https_ ? 443 : 80)) authority += ":" + std::to_string(port_);
+        return authority;
+    }
+
+    // Safe to replay (RFC 9110 section 9.2.2), which is what TLS 0-RTT requires: early data can
+    // be captured and re-sent by an attacker.
+    bool is_idempotent() const {
+        return method_ == "GET" || method_ == "HEAD" || method_ == "OPTIONS" ||
+               method_ == "PUT" || method_ == "DELETE" || method_ == "TRACE";
+    }
+
     Request& method(const std::string& method_str) {
         method_ = method_str;
         return *this;
@@ -67,9 +200,80 @@ public:
         return timeout_;
     }
 
+    // Scheduling class used when the request is queued by Client::async_send
+    Request& priority(utils::Priority p) {
+        priority_ = p;
+        return *this;
+    }
+
+    utils::Priority get_priority() const {
+        return priority_;
+    }
+
+    // Latest time the request may start; if it is still queued by then it is dropped and its
+    // future throws utils::DeadlineExceeded. Unlike timeout(), this bounds time spent waiting.
+    Request& deadline(std::chrono::steady_clock::time_point when) {
+        deadline_ = when;
+        return *this;
+    }
+
+    const std::optional<std::chrono::steady_clock::time_point>& get_deadline() const {
+        return deadline_;
+    }
+
+    // When enabled (the default), send() advertises the compiled-in codecs via Accept-Encoding
+    // and transparently decodes the response body. An Accept-Encoding header set by the caller
+    // is left untouched.
+    Request& decompress(bool enabled) {
+        decompress_ = enabled;
+        return *this;
+    }
+
+    // Upper bound on the response body after decoding (64 MiB by default). A larger body, e.g. a
+    // small gzip/zstd "decompression bomb", makes send() throw encoding::BodyTooLarge.
+    Request& max_body_size(size_t bytes) {
+        max_body_size_ = bytes;
+        return *this;
+    }
+
+    size_t get_max_body_size() const {
+        return max_body_size_;
+    }
+
+    // Replaces the built-in mock backend for every Request::send() in the process, e.g. with a
+    // socket transport talking to a test server. The transport delivers the response into the
+    // ResponseSink as it reads it. Pass an empty function to restore the mock.
+    // Install before issuing requests: the hook is not synchronized with in-flight sends.
+    using Transport = std::function<void(const Request&, ResponseSink&)>;
+
+    static void set_transport(Transport transport) {
+        transport_slot() = std::move(transport);
+    }
 
-    // Mocked send() method
     Response send() {
+        if (decompress_ && !encoding::find_header(headers_, "Accept-Encoding")) {
+            headers_["Accept-Encoding"] = encoding::accept_encoding_value();
+        }
+        ResponseSink sink(decompress_, max_body_size_, method_ != "HEAD");
+        const Transport& transport = transport_slot();
+        if (transport) {
+            transport(*this, sink);
+        } else {
+            Response response = transport_send();
+            sink.begin(response.status_code(), response.headers());
+            sink.write(response.body().data(), response.body().size());
+        }
+        return sink.finish();
+    }
+
+private:
+    static Transport& transport_slot() {
+        static Transport transport;
+        return transport;
+    }
+
+    // Mocked transport
+    Response transport_send() {
         std::map<std::string, std::string> response_headers = {
             {"Connection", "close"},
             {"Content-Type", "application/json"}
@@ -104,6 +308,31 @@ public:
             return Response(HTTP_STATUS_OK, ss_body.str(), response_headers);
         }
 
+        // --- Compressed Response Mock Logic ---
+        // Picks the first codec from our Accept-Encoding the way a server would, so the body
+        // comes back encoded and exercises the client-side decoder.
+        if (url_ == "http://example.com/compressed" || url_ == "https://example.com/compressed") {
+            std::string payload = "{\"message\": \"compressed GET success\", \"padding\": \"" + std::string(4096, 'x') + "\"}";
+            const std::string* accept = encoding::find_header(headers_, "Accept-Encoding");
+            encoding::ContentEncoding chosen = encoding::ContentEncoding::Identity;
+            if (accept) {
+                std::stringstream tokens(*accept);
+                std::string token;
+                while (std::getline(tokens, token, ',')) {
+                    encoding::ContentEncoding enc = encoding::parse_content_encoding(token.substr(0, token.find(';')));
+                    if (enc != encoding::ContentEncoding::Identity && encoding::is_supported(enc)) {
+                        chosen = enc;
+                        break;
+                    }
+                }
+            }
+            if (chosen != encoding::ContentEncoding::Identity) {
+                response_headers["Content-Encoding"] = chosen == encoding::ContentEncoding::Zstd ? "zstd"
+                                                     : chosen == encoding::ContentEncoding::Gzip ? "gzip" : "deflate";
+            }
+            return Response(HTTP_STATUS_OK, encoding::encode(chosen, payload), response_headers);
+        }
+
         // --- Existing Mock Logic (GET/POST) ---
         if (method_ == "GET") {
             if (url_ == "http://example.com/ok" || url_ == "https://example.com/ok") {
@@ -121,14 +350,19 @@ public:
         return Response(HTTP_STATUS_INTERNAL_SERVER_ERROR, "Mock Error: Unhandled URL/method. URL: " + url_, fallback_headers);
     }
 
-private:
     std::string url_;
     std::string method_;
     std::string body_;
     std::map<std::string, std::string> headers_;
     std::chrono::milliseconds timeout_; // Timeout for the request
+    utils::Priority priority_ = utils::Priority::Normal;
+    std::optional<std::chrono::steady_clock::time_point> deadline_;
     std::string host_;
     std::string path_;
+    unsigned short port_;
+    bool https_;
+    bool decompress_;
+    size_t max_body_size_;
 };
 
 } // namespace http
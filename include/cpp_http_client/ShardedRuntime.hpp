@@ -0,0 +1,452 @@
+#ifndef CPP_HTTP_CLIENT_SHARDEDRUNTIME_HPP
+#define CPP_HTTP_CLIENT_SHARDEDRUNTIME_HPP
+
+#include "SpscQueue.hpp"
+#include <vector>
+#include <deque>
+#include <algorithm> // For std::min
+#include <map>
+#include <string>
+#include <memory>
+#include <memory_resource>
+#include <typeindex>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <cstring>   // For std::memcpy
+#include <stdexcept> // For std::runtime_error
+
+#include <netdb.h>
+#include <sys/socket.h>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace http {
+namespace utils {
+
+// Resolver cache owned by a single shard, so lookups never contend with other cores.
+// getaddrinfo() does not report record TTLs; entries expire after a fixed interval instead.
+class DnsCache {
+public:
+    struct Address {
+        sockaddr_storage storage;
+        socklen_t length;
+    };
+
+    DnsCache(std::pmr::memory_resource* resource, std::chrono::seconds ttl = std::chrono::seconds(30))
+        : resource_(resource), ttl_(ttl), entries_(resource), hits_(0), misses_(0) {}
+
+    // Returns the addresses for host:port, resolving on a miss or expired entry.
+    // The reference stays valid until the next resolve() of the same key. Throws std::runtime_error.
+    const std::pmr::vector<Address>& resolve(const std::string& host, unsigned short port) {
+        std::pmr::string key(host, resource_);
+        key += ':';
+        key += std::to_string(port);
+
+        auto now = std::chrono::steady_clock::now();
+        auto it = entries_.find(key);
+        if (it != entries_.end() && it->second.expires > now) {
+            ++hits_;
+            return it->second.addresses;
+        }
+        ++misses_;
+
+        addrinfo hints = addrinfo();
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        addrinfo* results = nullptr;
+        int rc = getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &results);
+        if (rc != 0) throw std::runtime_error("getaddrinfo(" + host + ") failed: " + gai_strerror(rc));
+
+        if (it == entries_.end()) {
+            it = entries_.emplace(std::piecewise_construct, std::forward_as_tuple(std::move(key)),
+                                  std::forward_as_tuple(resource_)).first;
+        }
+        Entry& entry = it->second;
+        entry.addresses.clear();
+        for (addrinfo* ai = results; ai != nullptr; ai = ai->ai_next) {
+            Address address = Address();
+            std::memcpy(&address.storage, ai->ai_addr, ai->ai_addrlen);
+            address.length = static_cast<socklen_t>(ai->ai_addrlen);
+            entry.addresses.push_back(address);
+        }
+        freeaddrinfo(results);
+        entry.expires = now + ttl_;
+        return entry.addresses;
+    }
+
+    size_t hits() const { return hits_; }
+    size_t misses() const { return misses_; }
+
+private:
+    struct Entry {
+        explicit Entry(std::pmr::memory_resource* resource) : addresses(resource) {}
+        std::chrono::steady_clock::time_point expires;
+        std::pmr::vector<Address> addresses;
+    };
+
+    std::pmr::memory_resource* resource_;
+    std::chrono::seconds ttl_;
+    std::pmr::map<std::pmr::string, Entry> entries_;
+    size_t hits_;
+    size_t misses_;
+};
+
+class ShardedRuntime;
+
+// One core's slice of the runtime: an event loop thread plus state that only that thread
+// touches (allocator, DNS cache, and any per-shard objects such as connection pools).
+class Shard {
+public:
+    size_t index() const { return index_; }
+
+    // Unsynchronized pool allocator for shard-local data. Use only from this shard's thread.
+    std::pmr::memory_resource* memory_resource() { return &memory_; }
+
+    DnsCache& dns_cache() { return dns_cache_; }
+
+    // Per-shard instance of T (e.g. a connection pool), created on first use from the shard's
+    // memory_resource(). Shard thread only.
+    template<class T>
+    T& local() {
+        std::shared_ptr<void>& slot = locals_[std::type_index(typeid(T))];
+        if (!slot) slot = std::allocate_shared<T>(std::pmr::polymorphic_allocator<T>(&memory_));
+        return *static_cast<T*>(slot.get());
+    }
+
+    // The shard whose thread is calling, or nullptr when called from outside any shard.
+    static Shard* current() {
+        return current_slot();
+    }
+
+private:
+    friend class ShardedRuntime;
+    using Task = std::function<void()>;
+
+    static constexpr size_t MAX_BATCH = 64; // Tasks taken from one source before checking the next
+
+    Shard(ShardedRuntime* runtime, size_t index, size_t shard_count, size_t queue_capacity)
+        : runtime_(runtime), index_(index), dns_cache_(&memory_), overflow_(shard_count), overflow_count_(0),
+          stop_(false), parked_(false), sleeping_(false), inbox_pending_(false) {
+        for (size_t i = 0; i < shard_count; ++i) {
+            inbound_.emplace_back(new SpscQueue<Task>(i == index ? 2 : queue_capacity));
+        }
+    }
+
+    static Shard*& current_slot() {
+        thread_local Shard* shard = nullptr;
+        return shard;
+    }
+
+    bool has_work() const {
+        if (!local_.empty() || inbox_pending_.load(std::memory_order_acquire)) return true;
+        for (const auto& queue : inbound_) {
+            if (!queue->empty()) return true;
+        }
+        return false;
+    }
+
+    // Runs whatever is queued, a bounded batch per source so no source starves the others.
+    bool drain() {
+        bool worked = flush_overflow();
+        Task task;
+
+        for (size_t n = std::min(local_.size(), MAX_BATCH * 4); n > 0; --n) {
+            task = std::move(local_.front());
+            local_.pop_front();
+            task();
+            worked = true;
+        }
+        for (auto& queue : inbound_) {
+            for (size_t n = 0; n < MAX_BATCH && queue->try_pop(task); ++n) {
+                task();
+                worked = true;
+            }
+        }
+        if (inbox_pending_.load(std::memory_order_acquire)) {
+            std::deque<Task> batch;
+            {
+                std::unique_lock<std::mutex> lock(inbox_mutex_);
+                batch.swap(inbox_);
+                inbox_pending_.store(false, std::memory_order_release);
+            }
+            for (auto& t : batch) t();
+            worked = worked || !batch.empty();
+        }
+        return worked;
+    }
+
+    void run(int cpu);
+    bool flush_overflow();
+
+    void wake() {
+        std::atomic_thread_fence(std::memory_order_seq_cst); // Pairs with the fence in run()
+        if (sleeping_.load(std::memory_order_seq_cst)) {
+            std::unique_lock<std::mutex> lock(inbox_mutex_);
+            condition_.notify_one();
+        }
+    }
+
+    void push_external(Task task) {
+        {
+            std::unique_lock<std::mutex> lock(inbox_mutex_);
+            if (stop_) throw std::runtime_error("submit on stopped ShardedRuntime");
+            inbox_.push_back(std::move(task));
+            inbox_pending_.store(true, std::memory_order_release);
+        }
+        condition_.notify_one();
+    }
+
+    ShardedRuntime* runtime_;
+    size_t index_;
+    std::pmr::unsynchronized_pool_resource memory_;
+    DnsCache dns_cache_;
+    std::map<std::type_index, std::shared_ptr<void>> locals_; // Destroyed before memory_
+    std::thread thread_;
+
+    std::deque<Task> local_;                              // Submitted by this shard's own thread
+    std::vector<std::unique_ptr<SpscQueue<Task>>> inbound_; // inbound_[i] is fed only by shard i
+    std::vector<std::deque<Task>> overflow_; // overflow_[i]: tasks for shard i whose SPSC queue was full
+    size_t overflow_count_;
+
+    std::mutex inbox_mutex_; // Guards inbox_ (submissions from non-shard threads) and parking
+    std::condition_variable condition_;
+    std::deque<Task> inbox_;
+    bool stop_;   // Set at shutdown; rejects push_external()
+    bool parked_; // Idle during shutdown; guarded by ShardedRuntime::stop_mutex_
+    std::atomic<bool> sleeping_;
+    std::atomic<bool> inbox_pending_;
+};
+
+// Share-nothing executor: one pinned event-loop thread per core, each with its own queues and
+// shard-local state. Work submitted from a shard thread stays on that shard; work from other
+// threads is spread round-robin over the shards through their locked inboxes. Shard-to-shard
+// handoff uses one SPSC queue per (producer, consumer) pair, so that path takes no locks; when
+// that queue is full the producer holds the overflow itself and hands it over as space frees up.
+// Each shard runs its tasks one at a time, so blocking tasks are at most size() in flight.
+//
+// Ordering: tasks one shard posts to another run in posting order, as do tasks one outside
+// thread posts to the same shard. Tasks from different sources are not ordered.
+//
+// Shutdown: the destructor rejects further submissions from outside threads (they throw), then
+// keeps every shard running until all of them are idle at once, so tasks already queued and any
+// tasks they post to other shards still run.
+class ShardedRuntime {
+public:
+    // 'shards' == 0 means one per CPU this process may run on.
+    explicit ShardedRuntime(size_t shards = 0, size_t queue_capacity = 1024)
+        : next_external_(0), stopping_(false), active_(0), finished_(false) {
+        std::vector<int> cpus = allowed_cpus();
+        if (shards == 0) shards = cpus.size();
+        for (size_t i = 0; i < shards; ++i) {
+            shards_.emplace_back(new Shard(this, i, shards, queue_capacity));
+        }
+        active_ = shards;
+        for (size_t i = 0; i < shards; ++i) {
+            Shard* shard = shards_[i].get();
+            int cpu = cpus[i % cpus.size()];
+            shard->thread_ = std::thread([shard, cpu] { shard->run(cpu); });
+        }
+    }
+
+    ~ShardedRuntime() {
+        for (auto& shard : shards_) {
+            std::unique_lock<std::mutex> lock(shard->inbox_mutex_);
+            shard->stop_ = true; // Outside submissions accepted before this are still drained
+        }
+        stopping_.store(true, std::memory_order_seq_cst);
+        for (auto& shard : shards_) {
+            std::unique_lock<std::mutex> lock(shard->inbox_mutex_);
+            shard->condition_.notify_one();
+        }
+        for (auto& shard : shards_) shard->thread_.join();
+    }
+
+    ShardedRuntime(const ShardedRuntime&) = delete;
+    ShardedRuntime& operator=(const ShardedRuntime&) = delete;
+
+    size_t size() const { return shards_.size(); }
+
+    // Runs on the calling shard when called from one of this runtime's shard threads, otherwise
+    // on the next shard in round-robin order.
+    template<class F, class... Args>
+    auto submit(F&& f, Args&&... args)
+        -> std::future<typename std::invoke_result<F, Args...>::type>
+    {
+        Shard* current = Shard::current();
+        size_t target = (current && current->runtime_ == this)
+                        ? current->index()
+                        : next_external_.fetch_add(1, std::memory_order_relaxed) % shards_.size();
+        return submit_to(target, std::forward<F>(f), std::forward<Args>(args)...);
+    }
+
+    template<class F, class... Args>
+    auto submit_to(size_t shard, F&& f, Args&&... args)
+        -> std::future<typename std::invoke_result<F, Args...>::type>
+    {
+        using return_type = typename std::invoke_result<F, Args...>::type;
+
+        auto task = std::make_shared< std::packaged_task<return_type()> >(
+                std::bind(std::forward<F>(f), std::forward<Args>(args)...)
+            );
+        std::future<return_type> res = task->get_future();
+        post(shard % shards_.size(), [task](){ (*task)(); });
+        return res;
+    }
+
+private:
+    friend class Shard;
+
+    // CPUs in this thread's affinity mask (honours taskset / cpusets), in ascending order
+    static std::vector<int> allowed_cpus() {
+        std::vector<int> cpus;
+#ifdef __linux__
+        cpu_set_t mask;
+        CPU_ZERO(&mask);
+        if (sched_getaffinity(0, sizeof(mask), &mask) == 0) {
+            for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+                if (CPU_ISSET(cpu, &mask)) cpus.push_back(cpu);
+            }
+        }
+#endif
+        if (cpus.empty()) {
+            size_t cores = std::thread::hardware_concurrency();
+            if (cores == 0) cores = 2; // Fallback if hardware_concurrency returns 0
+            for (size_t i = 0; i < cores; ++i) cpus.push_back(static_cast<int>(i));
+        }
+        return cpus;
+    }
+
+    void post(size_t target, Shard::Task task) {
+        Shard& destination = *shards_[target];
+        Shard* current = Shard::current();
+        if (current && current->runtime_ == this) {
+            if (current == &destination) {
+                current->local_.push_back(std::move(task));
+                return;
+            }
+            std::deque<Shard::Task>& overflow = current->overflow_[target];
+            if (overflow.empty() && destination.inbound_[current->index()]->try_push(std::move(task))) {
+                signal(destination);
+                return;
+            }
+            // Queue full, or older tasks are still waiting for it: queue behind them rather than
+            // block this shard or overtake them through the inbox. drain() flushes the overflow.
+            overflow.push_back(std::move(task));
+            ++current->overflow_count_;
+            return;
+        }
+        destination.push_external(std::move(task));
+    }
+
+    // Called by a shard thread after handing 'destination' a task.
+    void signal(Shard& destination) {
+        destination.wake(); // Its fence orders the push before the stopping_ load
+        if (!stopping_.load(std::memory_order_seq_cst)) return;
+        std::unique_lock<std::mutex> lock(stop_mutex_);
+        if (destination.parked_) {
+            // The calling shard is active, so active_ cannot have reached zero yet
+            destination.parked_ = false;
+            ++active_;
+            stop_condition_.notify_all();
+        }
+    }
+
+    // Shutdown idle path of a shard thread. Returns true once every shard is idle, i.e. no task is
+    // queued or running anywhere and none can be posted any more; false when new work arrived.
+    bool park_until_done(Shard& shard) {
+        std::unique_lock<std::mutex> lock(stop_mutex_);
+        std::atomic_thread_fence(std::memory_order_seq_cst); // Pairs with the fence in signal()
+        if (shard.has_work() || shard.overflow_count_ > 0) return false;
+        shard.parked_ = true;
+        if (--active_ == 0) {
+            finished_ = true;
+            stop_condition_.notify_all();
+            return true;
+        }
+        stop_condition_.wait(lock, [&] { return finished_ || !shard.parked_; });
+        return finished_;
+    }
+
+    std::vector<std::unique_ptr<Shard>> shards_;
+    std::atomic<size_t> next_external_;
+
+    std::atomic<bool> stopping_;
+    std::mutex stop_mutex_; // Guards active_, finished_ and Shard::parked_
+    std::condition_variable stop_condition_;
+    size_t active_; // Shards not parked in park_until_done()
+    bool finished_;
+};
+
+// Moves held-back tasks into their destinations' SPSC queues, oldest first. Returns true if any moved.
+inline bool Shard::flush_overflow() {
+    if (overflow_count_ == 0) return false;
+    bool moved = false;
+    for (size_t i = 0; i < overflow_.size(); ++i) {
+        std::deque<Task>& pending = overflow_[i];
+        if (pending.empty()) continue;
+        Shard& destination = *runtime_->shards_[i];
+        SpscQueue<Task>& queue = *destination.inbound_[index_];
+        size_t before = pending.size();
+        while (!pending.empty() && queue.try_push(std::move(pending.front()))) pending.pop_front();
+        if (pending.size() != before) {
+            overflow_count_ -= before - pending.size();
+            runtime_->signal(destination);
+            moved = true;
+        }
+    }
+    return moved;
+}
+
+inline void Shard::run(int cpu) {
+    current_slot() = this;
+#ifdef __linux__
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(cpu, &cpus);
+    pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus); // Best effort
+#else
+    (void)cpu;
+#endif
+    for (;;) {
+        if (drain()) continue;
+        if (overflow_count_ > 0) {
+            std::this_thread::yield(); // A destination queue is full; retry once it has drained
+            continue;
+        }
+
+        // Brief spin before parking: cross-shard handoffs usually arrive in bursts.
+        bool found = false;
+        for (int spin = 0; spin < 256 && !found; ++spin) {
+            found = has_work();
+            if (!found) std::this_thread::yield();
+        }
+        if (found) continue;
+
+        if (runtime_->stopping_.load(std::memory_order_seq_cst)) {
+            if (runtime_->park_until_done(*this)) break;
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(inbox_mutex_);
+        sleeping_.store(true, std::memory_order_seq_cst);
+        std::atomic_thread_fence(std::memory_order_seq_cst); // Pairs with the fence in wake()
+        if (!has_work() && !runtime_->stopping_.load(std::memory_order_seq_cst)) {
+            // The timeout only bounds a missed wake-up; producers normally notify.
+            condition_.wait_for(lock, std::chrono::milliseconds(10));
+        }
+        sleeping_.store(false, std::memory_order_relaxed);
+    }
+    current_slot() = nullptr;
+}
+
+} // namespace utils
+} // namespace http
+
+#endif // CPP_HTTP_CLIENT_SHARDEDRUNTIME_HPP
@@ -0,0 +1,73 @@
+#ifndef CPP_HTTP_CLIENT_SPSCQUEUE_HPP
+#define CPP_HTTP_CLIENT_SPSCQUEUE_HPP
+
+#include <atomic>
+#include <vector>
+#include <cstddef> // For size_t
+#include <utility> // For std::move
+
+namespace http {
+namespace utils {
+
+// Bounded lock-free queue for exactly one producer thread and one consumer thread.
+// Head and tail live on separate cache lines, and each side keeps a cached copy of the other's
+// index so the shared atomics are only re-read when the queue looks full or empty.
+template<class T>
+class SpscQueue {
+public:
+    // Capacity is rounded up to a power of two.
+    explicit SpscQueue(size_t capacity) : buffer_(round_up(capacity)), mask_(buffer_.size() - 1) {}
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    // Producer side. Returns false (and leaves 'value' untouched) if the queue is full.
+    bool try_push(T&& value) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - cached_head_ == buffer_.size()) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            if (tail - cached_head_ == buffer_.size()) return false;
+        }
+        buffer_[tail & mask_] = std::move(value);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side. Returns false if the queue is empty.
+    bool try_pop(T& out) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head == cached_tail_) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            if (head == cached_tail_) return false;
+        }
+        out = std::move(buffer_[head & mask_]);
+        buffer_[head & mask_] = T(); // Release captured state now, not when the slot is reused
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Approximate; exact only when called from the consumer with no concurrent push.
+    bool empty() const {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+
+private:
+    static size_t round_up(size_t n) {
+        size_t capacity = 2;
+        while (capacity < n) capacity <<= 1;
+        return capacity;
+    }
+
+    std::vector<T> buffer_;
+    const size_t mask_;
+
+    alignas(64) std::atomic<size_t> head_{0}; // Written by the consumer
+    alignas(64) size_t cached_tail_ = 0;      // Consumer's copy of tail_
+    alignas(64) std::atomic<size_t> tail_{0}; // Written by the producer
+    alignas(64) size_t cached_head_ = 0;      // Producer's copy of head_
+};
+
+} // namespace utils
+} // namespace http
+
+#endif // CPP_HTTP_CLIENT_SPSCQUEUE_HPP
@@ -0,0 +1,33 @@
+#ifndef CPP_HTTP_CLIENT_TASKOPTIONS_HPP
+#define CPP_HTTP_CLIENT_TASKOPTIONS_HPP
+
+#include <chrono>
+#include <optional>
+#include <stdexcept> // For std::runtime_error
+
+namespace http {
+namespace utils {
+
+// Scheduling class of a task. Higher classes are served first; see ThreadPool for aging.
+enum class Priority {
+    High = 0,   // Latency-critical, e.g. interactive GETs
+    Normal = 1, // Default for enqueue()
+    Low = 2     // Bulk/batch work, e.g. large uploads
+};
+
+struct TaskOptions {
+    Priority priority = Priority::Normal;
+    // If set and already passed when a worker picks the task up, the task is not run and its
+    // future throws DeadlineExceeded instead.
+    std::optional<std::chrono::steady_clock::time_point> deadline;
+};
+
+class DeadlineExceeded : public std::runtime_error {
+public:
+    DeadlineExceeded() : std::runtime_error("Task deadline passed before it was started") {}
+};
+
+} // namespace utils
+} // namespace http
+
+#endif // CPP_HTTP_CLIENT_TASKOPTIONS_HPP
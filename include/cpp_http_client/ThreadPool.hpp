@@ -1,21 +1,31 @@
 #ifndef CPP_HTTP_CLIENT_THREADPOOL_HPP
 #define CPP_HTTP_CLIENT_THREADPOOL_HPP
 
+#include "TaskOptions.hpp"
 #include <vector>
-#include <queue>
+#include <deque>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
 #include <functional>
 #include <future>
+#include <atomic>
+#include <chrono>
+#include <optional>
+#include <type_traits>
 #include <stdexcept> // For std::runtime_error
 
 namespace http {
 namespace utils { // Encapsulate ThreadPool in a sub-namespace
 
+// Workers take the oldest task of the highest non-empty priority class. To prevent starvation
+// the head of a lower class is served first once it has waited one 'aging_interval' per class
+// of difference and is older than the head of the higher class, so under sustained
+// high-priority load bulk work still progresses.
 class ThreadPool {
 public:
-    ThreadPool(size_t threads) : stop(false) {
+    ThreadPool(size_t threads, std::chrono::milliseconds aging = std::chrono::milliseconds(50))
+        : stop(false), pending(0), expired(0), aging_interval(aging) {
         if (threads == 0) {
             threads = std::thread::hardware_concurrency(); // Default to hardware concurrency
         }
@@ -26,33 +36,67 @@ public:
             workers.emplace_back(
                 [this] {
                     for(;;) {
-                        std::function<void()> task;
+                        QueuedTask task;
                         {
                             std::unique_lock<std::mutex> lock(this->queue_mutex);
                             this->condition.wait(lock,
-                                [this]{ return this->stop || !this->tasks.empty(); });
-                            if(this->stop && this->tasks.empty())
+                                [this]{ return this->stop || this->pending > 0; });
+                            if(this->stop && this->pending == 0)
                                 return;
-                            task = std::move(this->tasks.front());
-                            this->tasks.pop();
+                            std::deque<QueuedTask>& queue = this->tasks[this->next_class()];
+                            task = std::move(queue.front());
+                            queue.pop_front();
+                            --this->pending;
+                        }
+                        if(task.deadline && std::chrono::steady_clock::now() > *task.deadline) {
+                            ++this->expired;
+                            task.expire();
+                        } else {
+                            task.run();
                         }
-                        task();
                     }
                 }
             );
     }
 
+    // Normal priority, no deadline.
     template<class F, class... Args>
     auto enqueue(F&& f, Args&&... args)
         -> std::future<typename std::invoke_result<F, Args...>::type>
+    {
+        return enqueue_with(TaskOptions(), std::forward<F>(f), std::forward<Args>(args)...);
+    }
+
+    template<class F, class... Args>
+    auto enqueue_with(const TaskOptions& options, F&& f, Args&&... args)
+        -> std::future<typename std::invoke_result<F, Args...>::type>
     {
         using return_type = typename std::invoke_result<F, Args...>::type;
 
-        auto task = std::make_shared< std::packaged_task<return_type()> >(
-                std::bind(std::forward<F>(f), std::forward<Args>(args)...)
-            );
+        // A promise rather than a packaged_task, so an expired task can be failed without running it.
+        auto promise = std::make_shared< std::promise<return_type> >();
+        auto bound = std::bind(std::forward<F>(f), std::forward<Args>(args)...);
+        auto fn = std::make_shared<decltype(bound)>(std::move(bound)); // Shared so move-only callables work
 
-        std::future<return_type> res = task->get_future();
+        std::future<return_type> res = promise->get_future();
+        QueuedTask task;
+        task.run = [promise, fn]() {
+            try {
+                if constexpr (std::is_void<return_type>::value) {
+                    (*fn)();
+                    promise->set_value();
+                } else {
+                    promise->set_value((*fn)());
+                }
+            } catch(...) {
+                promise->set_exception(std::current_exception());
+            }
+        };
+        task.expire = [promise]() {
+            promise->set_exception(std::make_exception_ptr(DeadlineExceeded()));
+        };
+        task.deadline = options.deadline;
+        task.enqueued = std::chrono::steady_clock::now();
         {
             std::unique_lock<std::mutex> lock(queue_mutex);
 
@@ -60,12 +104,23 @@ public:
             if(stop)
                 throw std::runtime_error("enqueue on stopped ThreadPool");
 
-            tasks.emplace([task](){ (*task)(); });
+            tasks[static_cast<size_t>(options.priority)].push_back(std::move(task));
+            ++pending;
         }
         condition.notify_one();
         return res;
     }
 
+    // Number of worker threads.
+    size_t size() const {
+        return workers.size();
+    }
+
+    // Number of tasks dropped because their deadline passed before a worker reached them.
+    size_t expired_count() const {
+        return expired.load();
+    }
+
     ~ThreadPool() {
         {
             std::unique_lock<std::mutex> lock(queue_mutex);
@@ -77,12 +132,45 @@ public:
     }
 
 private:
+    static constexpr size_t PRIORITY_CLASSES = 3;
+
+    struct QueuedTask {
+        std::function<void()> run;
+        std::function<void()> expire;
+        std::optional<std::chrono::steady_clock::time_point> deadline;
+        std::chrono::steady_clock::time_point enqueued;
+    };
+
+    // Index of the class to serve next; queue_mutex must be held and pending > 0.
+    // A lower class wins over a higher one when its oldest task is older than the higher class's
+    // oldest and has waited at least one aging interval per class of difference.
+    size_t next_class() const {
+        auto now = std::chrono::steady_clock::now();
+        size_t best = PRIORITY_CLASSES;
+        for(size_t c = 0; c < PRIORITY_CLASSES; ++c) {
+            if(tasks[c].empty())
+                continue;
+            if(best == PRIORITY_CLASSES) {
+                best = c;
+                continue;
+            }
+            const auto& candidate = tasks[c].front();
+            if(candidate.enqueued < tasks[best].front().enqueued &&
+               now - candidate.enqueued >= aging_interval * static_cast<int>(c - best))
+                best = c;
+        }
+        return best;
+    }
+
     std::vector<std::thread> workers;
-    std::queue<std::function<void()>> tasks;
+    std::deque<QueuedTask> tasks[PRIORITY_CLASSES]; // FIFO per Priority, indexed by its value
 
     std::mutex queue_mutex;
     std::condition_variable condition;
     bool stop;
+    size_t pending;
+    std::atomic<size_t> expired;
+    std::chrono::milliseconds aging_interval;
 };
 
 } // namespace utils
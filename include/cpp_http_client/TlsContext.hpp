@@ -0,0 +1,573 @@
+#ifndef CPP_HTTP_CLIENT_TLSCONTEXT_HPP
+#define CPP_HTTP_CLIENT_TLSCONTEXT_HPP
+
+// TLS layer for https:// connections: a client SSL_CTX wrapper, a per-host session cache used
+// for ticket / session-ID resumption and TLS 1.3 0-RTT, and a connector that runs handshakes
+// on a dedicated thread pool so a full handshake never blocks other connections.
+//
+// Requires OpenSSL 1.1.1+ and a POSIX socket API. The build defines CPP_HTTP_CLIENT_WITH_OPENSSL
+// when OpenSSL is found (see CMakeLists.txt); without it this header is empty. Connections
+// send with MSG_NOSIGNAL, so a peer reset surfaces as an exception, never as SIGPIPE, and every
+// connect, handshake read and later read/write is bounded by the connector's timeout.
+
+#ifdef CPP_HTTP_CLIENT_WITH_OPENSSL
+
+#include "ThreadPool.hpp"
+#include "ShardedRuntime.hpp" // For the shard-local DnsCache
+#include "Request.hpp"
+#include <openssl/ssl.h>
+#include <openssl/err.h>
+#include <openssl/x509.h>
+#include <openssl/pem.h>
+#include <string>
+#include <map>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <algorithm> // For std::min, std::max
+#include <climits>   // For INT_MAX
+#include <cstdint>
+#include <cerrno>
+#include <cstring>   // For std::strlen
+#include <ctime>
+#include <stdexcept> // For std::runtime_error
+
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+namespace http {
+namespace tls { // Encapsulate the OpenSSL-backed pieces in a sub-namespace
+
+// Same default as Request::timeout().
+const std::chrono::milliseconds DEFAULT_IO_TIMEOUT(30000);
+
+// Bounds each blocking send()/recv() on 'fd'. OpenSSL sees an expired wait as a retryable
+// error, which TlsConnection reports as a timeout.
+inline void set_io_timeout(int fd, std::chrono::milliseconds timeout) {
+    timeval tv;
+    long long ms = std::max<long long>(timeout.count(), 1); // 0 would mean "wait forever"
+    tv.tv_sec = static_cast<time_t>(ms / 1000);
+    tv.tv_usec = static_cast<suseconds_t>((ms % 1000) * 1000);
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+}
+
+inline std::runtime_error openssl_error(const std::string& what) {
+    unsigned long code = ERR_get_error();
+    char buf[256] = "no OpenSSL error queued";
+    if (code != 0) ERR_error_string_n(code, buf, sizeof(buf));
+    ERR_clear_error();
+    return std::runtime_error(what + ": " + buf);
+}
+
+// Snapshot of handshake counters, so resumption rate and handshake cost can be observed.
+struct TlsStats {
+    uint64_t full_handshakes = 0;
+    uint64_t resumed_handshakes = 0;
+    std::chrono::nanoseconds full_handshake_time{0};    // Sum over all full handshakes
+    std::chrono::nanoseconds resumed_handshake_time{0}; // Sum over all resumed handshakes
+    uint64_t early_data_accepted = 0;
+    uint64_t early_data_rejected = 0;
+
+    double resumption_rate() const {
+        uint64_t total = full_handshakes + resumed_handshakes;
+        return total == 0 ? 0.0 : static_cast<double>(resumed_handshakes) / total;
+    }
+};
+
+// Socket BIO equivalent to BIO_s_socket() except that writes use send(MSG_NOSIGNAL). OpenSSL's
+// own socket BIO calls write(), which raises SIGPIPE when the peer has reset the connection.
+// The BIO does not own the descriptor.
+inline int socket_bio_fd(BIO* bio) {
+    return static_cast<int>(reinterpret_cast<intptr_t>(BIO_get_data(bio)));
+}
+
+inline int socket_bio_write(BIO* bio, const char* data, int len) {
+    errno = 0;
+    int n = static_cast<int>(::send(socket_bio_fd(bio), data, static_cast<size_t>(len), MSG_NOSIGNAL));
+    BIO_clear_retry_flags(bio);
+    if (n <= 0 && BIO_sock_should_retry(n)) BIO_set_retry_write(bio);
+    return n;
+}
+
+inline int socket_bio_read(BIO* bio, char* data, int len) {
+    errno = 0;
+    int n = static_cast<int>(::recv(socket_bio_fd(bio), data, static_cast<size_t>(len), 0));
+    BIO_clear_retry_flags(bio);
+    if (n <= 0 && BIO_sock_should_retry(n)) BIO_set_retry_read(bio);
+    return n;
+}
+
+inline int socket_bio_puts(BIO* bio, const char* str) {
+    return socket_bio_write(bio, str, static_cast<int>(std::strlen(str)));
+}
+
+inline long socket_bio_ctrl(BIO* bio, int cmd, long, void* ptr) {
+    switch (cmd) {
+    case BIO_C_GET_FD:
+        if (ptr) *static_cast<int*>(ptr) = socket_bio_fd(bio);
+        return socket_bio_fd(bio);
+    case BIO_CTRL_FLUSH:
+    case BIO_CTRL_DUP:
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+inline BIO* new_socket_bio(int fd) {
+    static BIO_METHOD* method = [] {
+        BIO_METHOD* m = BIO_meth_new(BIO_get_new_index() | BIO_TYPE_SOURCE_SINK | BIO_TYPE_DESCRIPTOR,
+                                     "socket (MSG_NOSIGNAL)");
+        if (m) {
+            BIO_meth_set_write(m, &socket_bio_write);
+            BIO_meth_set_read(m, &socket_bio_read);
+            BIO_meth_set_puts(m, &socket_bio_puts);
+            BIO_meth_set_ctrl(m, &socket_bio_ctrl);
+        }
+        return m; // Lives for the whole process
+    }();
+    BIO* bio = method ? BIO_new(method) : nullptr;
+    if (!bio) throw openssl_error("Failed to create socket BIO");
+    BIO_set_data(bio, reinterpret_cast<void*>(static_cast<intptr_t>(fd)));
+    BIO_set_init(bio, 1);
+    return bio;
+}
+
+// Sessions (TLS 1.2 session IDs / tickets, TLS 1.3 tickets) keyed by "host:port". TLS 1.3
+// tickets are meant to be used once, so take() removes them and the fresh tickets servers send
+// on every connection refill the cache. TLS 1.2 sessions stay cached for reuse: OpenSSL reports
+// no new session after a TLS 1.2 resumption, so removing them would force every other
+// handshake to be a full one.
+class SessionCache {
+public:
+    explicit SessionCache(size_t max_sessions_per_host = 4) : max_per_host_(max_sessions_per_host) {}
+
+    ~SessionCache() {
+        clear();
+    }
+
+    SessionCache(const SessionCache&) = delete;
+    SessionCache& operator=(const SessionCache&) = delete;
+
+    // Takes ownership of one reference to 'session'.
+    void store(const std::string& key, SSL_SESSION* session) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        auto& sessions = sessions_[key];
+        sessions.push_back(session);
+        while (sessions.size() > max_per_host_) {
+            SSL_SESSION_free(sessions.front());
+            sessions.pop_front();
+        }
+    }
+
+    // Returns the newest still-valid session for 'key' (caller owns the reference), or nullptr.
+    SSL_SESSION* take(const std::string& key) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        auto it = sessions_.find(key);
+        if (it == sessions_.end()) return nullptr;
+        auto& sessions = it->second;
+        while (!sessions.empty()) {
+            SSL_SESSION* session = sessions.back();
+            if (SSL_SESSION_is_resumable(session) &&
+                SSL_SESSION_get_time(session) + SSL_SESSION_get_timeout(session) > std::time(nullptr)) {
+                if (SSL_SESSION_get_protocol_version(session) == TLS1_3_VERSION) {
+                    sessions.pop_back(); // Single-use ticket
+                } else {
+                    SSL_SESSION_up_ref(session);
+                }
+                return session;
+            }
+            sessions.pop_back();
+            SSL_SESSION_free(session);
+        }
+        return nullptr;
+    }
+
+    // Drops 'session' from 'key' if still cached, e.g. after the server declined to resume it.
+    void discard(const std::string& key, SSL_SESSION* session) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        auto it = sessions_.find(key);
+        if (it == sessions_.end()) return;
+        auto& sessions = it->second;
+        for (auto s = sessions.begin(); s != sessions.end(); ++s) {
+            if (*s == session) {
+                SSL_SESSION_free(*s);
+                sessions.erase(s);
+                return;
+            }
+        }
+    }
+
+    void clear() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (auto& pair : sessions_) {
+            for (SSL_SESSION* session : pair.second) SSL_SESSION_free(session);
+        }
+        sessions_.clear();
+    }
+
+private:
+    size_t max_per_host_;
+    std::mutex mutex_;
+    std::map<std::string, std::deque<SSL_SESSION*>> sessions_;
+};
+
+class TlsConnection;
+
+// Client-side SSL_CTX shared by all connections. Peer verification is on by default against
+// the system trust store; trust_pem()/trust_file() add further roots (e.g. a self-signed cert).
+class TlsContext {
+public:
+    TlsContext() : ctx_(SSL_CTX_new(TLS_client_method())), early_data_(true) {
+        if (!ctx_) throw openssl_error("SSL_CTX_new failed");
+        SSL_CTX_set_min_proto_version(ctx_, TLS1_2_VERSION);
+        SSL_CTX_set_verify(ctx_, SSL_VERIFY_PEER, nullptr);
+        SSL_CTX_set_default_verify_paths(ctx_);
+        // OpenSSL's internal client cache is not keyed by host, so sessions are handed to our
+        // own cache from the new-session callback instead. This also catches TLS 1.3 tickets,
+        // which arrive after the handshake has completed.
+        SSL_CTX_set_session_cache_mode(ctx_, SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+        SSL_CTX_sess_set_new_cb(ctx_, &TlsContext::on_new_session);
+        SSL_CTX_set_app_data(ctx_, this);
+    }
+
+    ~TlsContext() {
+        SSL_CTX_free(ctx_);
+    }
+
+    TlsContext(const TlsContext&) = delete;
+    TlsContext& operator=(const TlsContext&) = delete;
+
+    TlsContext& verify_peer(bool enabled) {
+        SSL_CTX_set_verify(ctx_, enabled ? SSL_VERIFY_PEER : SSL_VERIFY_NONE, nullptr);
+        return *this;
+    }
+
+    TlsContext& trust_file(const std::string& ca_file) {
+        if (SSL_CTX_load_verify_locations(ctx_, ca_file.c_str(), nullptr) != 1) {
+            throw openssl_error("Failed to load CA file " + ca_file);
+        }
+        return *this;
+    }
+
+    TlsContext& trust_pem(const std::string& pem) {
+        std::unique_ptr<BIO, decltype(&BIO_free)> bio(BIO_new_mem_buf(pem.data(), static_cast<int>(pem.size())), &BIO_free);
+        X509_STORE* store = SSL_CTX_get_cert_store(ctx_);
+        int added = 0;
+        while (X509* cert = PEM_read_bio_X509(bio.get(), nullptr, nullptr, nullptr)) {
+            X509_STORE_add_cert(store, cert);
+            X509_free(cert);
+            ++added;
+        }
+        ERR_clear_error(); // PEM_read_bio_X509 leaves an error at end of input
+        if (added == 0) throw std::runtime_error("No certificates found in PEM data");
+        return *this;
+    }
+
+    // Allows TLS 1.3 0-RTT when the cached session permits it. Callers only pass early data for
+    // idempotent requests, since the server may see a replayed copy.
+    TlsContext& early_data(bool enabled) {
+        early_data_ = enabled;
+        return *this;
+    }
+
+    bool early_data_enabled() const { return early_data_; }
+
+    SessionCache& sessions() { return sessions_; }
+
+    SSL_CTX* native_handle() { return ctx_; }
+
+    TlsStats stats() const {
+        TlsStats s;
+        s.full_handshakes = full_handshakes_.load();
+        s.resumed_handshakes = resumed_handshakes_.load();
+        s.full_handshake_time = std::chrono::nanoseconds(full_handshake_ns_.load());
+        s.resumed_handshake_time = std::chrono::nanoseconds(resumed_handshake_ns_.load());
+        s.early_data_accepted = early_data_accepted_.load();
+        s.early_data_rejected = early_data_rejected_.load();
+        return s;
+    }
+
+    void record_handshake(bool resumed, std::chrono::nanoseconds elapsed) {
+        if (resumed) {
+            ++resumed_handshakes_;
+            resumed_handshake_ns_ += static_cast<uint64_t>(elapsed.count());
+        } else {
+            ++full_handshakes_;
+            full_handshake_ns_ += static_cast<uint64_t>(elapsed.count());
+        }
+    }
+
+    void record_early_data(bool accepted) {
+        if (accepted) ++early_data_accepted_; else ++early_data_rejected_;
+    }
+
+private:
+    static int on_new_session(SSL* ssl, SSL_SESSION* session);
+
+    SSL_CTX* ctx_;
+    bool early_data_;
+    SessionCache sessions_;
+    std::atomic<uint64_t> full_handshakes_{0};
+    std::atomic<uint64_t> resumed_handshakes_{0};
+    std::atomic<uint64_t> full_handshake_ns_{0};
+    std::atomic<uint64_t> resumed_handshake_ns_{0};
+    std::atomic<uint64_t> early_data_accepted_{0};
+    std::atomic<uint64_t> early_data_rejected_{0};
+};
+
+// One TLS session over a connected, blocking TCP socket. Owns the socket.
+class TlsConnection {
+public:
+    TlsConnection(TlsContext& context, int fd, const std::string& host, unsigned short port)
+        : context_(context), fd_(fd), ssl_(SSL_new(context.native_handle())),
+          session_key_(host + ":" + std::to_string(port)), resumed_(false), early_data_accepted_(false) {
+        if (!ssl_) {
+            ::close(fd_);
+            throw openssl_error("SSL_new failed");
+        }
+        BIO* bio = nullptr;
+        try {
+            bio = new_socket_bio(fd_);
+        } catch (...) {
+            SSL_free(ssl_);
+            ::close(fd_);
+            throw;
+        }
+        SSL_set_bio(ssl_, bio, bio); // One reference, shared for both directions
+        SSL_set_app_data(ssl_, this);
+        SSL_set_tlsext_host_name(ssl_, host.c_str()); // SNI
+        SSL_set1_host(ssl_, host.c_str());            // Certificate hostname check
+    }
+
+    ~TlsConnection() {
+        if (SSL_is_init_finished(ssl_)) SSL_shutdown(ssl_); // Best-effort close_notify
+        SSL_free(ssl_);
+        ::close(fd_);
+    }
+
+    TlsConnection(const TlsConnection&) = delete;
+    TlsConnection& operator=(const TlsConnection&) = delete;
+
+    // Resumes a cached session for this host when one exists. If 'early_data' is given and the
+    // session allows 0-RTT, it is sent with the ClientHello; otherwise (or if the server rejects
+    // it) it is written right after the handshake, so the caller sees the same result either way.
+    void handshake(const std::string& early_data = "") {
+        auto start = std::chrono::steady_clock::now();
+
+        std::unique_ptr<SSL_SESSION, decltype(&SSL_SESSION_free)> session(
+            context_.sessions().take(session_key_), &SSL_SESSION_free);
+        if (session) SSL_set_session(ssl_, session.get());
+
+        bool sent_early = false;
+        if (!early_data.empty() && session && context_.early_data_enabled() &&
+            early_data.size() <= SSL_SESSION_get_max_early_data(session.get())) {
+            size_t written = 0;
+            if (SSL_write_early_data(ssl_, early_data.data(), early_data.size(), &written) != 1) {
+                throw openssl_error("SSL_write_early_data failed");
+            }
+            sent_early = true;
+        }
+
+        int rc = SSL_connect(ssl_);
+        if (rc != 1) {
+            if (would_block(rc)) throw std::runtime_error("TLS handshake with " + session_key_ + " timed out");
+            throw openssl_error("TLS handshake with " + session_key_ + " failed");
+        }
+        resumed_ = SSL_session_reused(ssl_) == 1;
+        if (session && !resumed_) context_.sessions().discard(session_key_, session.get());
+        context_.record_handshake(resumed_, std::chrono::steady_clock::now() - start);
+
+        if (sent_early) {
+            early_data_accepted_ = SSL_get_early_data_status(ssl_) == SSL_EARLY_DATA_ACCEPTED;
+            context_.record_early_data(early_data_accepted_);
+        }
+        if (!early_data.empty() && !early_data_accepted_) {
+            write(early_data.data(), early_data.size());
+        }
+    }
+
+    void write(const char* data, size_t len) {
+        while (len > 0) {
+            size_t written = 0;
+            int rc = SSL_write_ex(ssl_, data, len, &written);
+            if (rc != 1) {
+                if (would_block(rc)) throw std::runtime_error("SSL_write to " + session_key_ + " timed out");
+                throw openssl_error("SSL_write to " + session_key_ + " failed");
+            }
+            data += written;
+            len -= written;
+        }
+    }
+
+    // Returns 0 once the peer has closed the connection.
+    size_t read(char* buf, size_t len) {
+        size_t n = 0;
+        int rc = SSL_read_ex(ssl_, buf, len, &n);
+        if (rc == 1) return n;
+        if (would_block(rc)) throw std::runtime_error("SSL_read from " + session_key_ + " timed out");
+        int err = SSL_get_error(ssl_, rc);
+        if (err == SSL_ERROR_ZERO_RETURN) return 0;
+        if (err == SSL_ERROR_SYSCALL && ERR_peek_error() == 0) return 0; // Peer closed without close_notify
+        throw openssl_error("SSL_read from " + session_key_ + " failed");
+    }
+
+    bool resumed() const { return resumed_; }
+    bool early_data_accepted() const { return early_data_accepted_; }
+    const std::string& session_key() const { return session_key_; }
+
+private:
+    // The socket is blocking, so "retry later" only happens when SO_RCVTIMEO/SO_SNDTIMEO expired.
+    bool would_block(int rc) const {
+        int err = SSL_get_error(ssl_, rc);
+        if (err != SSL_ERROR_WANT_READ && err != SSL_ERROR_WANT_WRITE) return false;
+        ERR_clear_error();
+        return true;
+    }
+
+    TlsContext& context_;
+    int fd_;
+    SSL* ssl_;
+    std::string session_key_;
+    bool resumed_;
+    bool early_data_accepted_;
+};
+
+inline int TlsContext::on_new_session(SSL* ssl, SSL_SESSION* session) {
+    auto* connection = static_cast<TlsConnection*>(SSL_get_app_data(ssl));
+    auto* context = static_cast<TlsContext*>(SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl)));
+    if (!connection || !context) return 0;
+    context->sessions().store(connection->session_key(), session);
+    return 1; // We keep the reference OpenSSL passed in
+}
+
+// Opens TCP connections and runs TLS handshakes on its own thread pool. Full handshakes cost
+// milliseconds of CPU; keeping them off the request workers means a reconnect storm delays only
+// the connections that are handshaking.
+class TlsConnector {
+public:
+    explicit TlsConnector(TlsContext& context, size_t handshake_threads = 2)
+        : context_(context), pool_(handshake_threads) {}
+
+    // 'early_data' (typically the serialized request) is sent as 0-RTT when possible; pass it
+    // only for idempotent requests (see Request::is_idempotent()). 'timeout' covers the TCP
+    // connect and the handshake together, counted from when a handshake thread picks the job up,
+    // and then bounds each read and write on the returned connection.
+    std::future<std::unique_ptr<TlsConnection>> async_connect(const std::string& host, unsigned short port,
+                                                              const std::string& early_data = "",
+                                                              std::chrono::milliseconds timeout = DEFAULT_IO_TIMEOUT) {
+        TlsContext& context = context_;
+        return pool_.enqueue([&context, host, port, early_data, timeout]() -> std::unique_ptr<TlsConnection> {
+            auto deadline = std::chrono::steady_clock::now() + timeout;
+            int fd = connect_tcp(host, port, timeout);
+            set_io_timeout(fd, remaining(deadline));
+            std::unique_ptr<TlsConnection> connection(new TlsConnection(context, fd, host, port));
+            connection->handshake(early_data);
+            set_io_timeout(fd, timeout);
+            return connection;
+        });
+    }
+
+    // Connects to the request's host and port within Request::get_timeout().
+    std::future<std::unique_ptr<TlsConnection>> async_connect(const Request& request,
+                                                              const std::string& early_data = "") {
+        return async_connect(request.get_host(), request.get_port(), early_data, request.get_timeout());
+    }
+
+    // TCP connect with Nagle disabled, giving up on all addresses once 'timeout' has passed; the
+    // returned socket is blocking with 'timeout' set as its send/receive timeout. Called on a
+    // utils::ShardedRuntime shard thread it resolves through that shard's DnsCache. getaddrinfo()
+    // cannot be interrupted, so a slow resolver can still exceed 'timeout'.
+    // Throws std::runtime_error on failure.
+    static int connect_tcp(const std::string& host, unsigned short port,
+                           std::chrono::milliseconds timeout = DEFAULT_IO_TIMEOUT) {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        bool timed_out = false;
+        int fd = -1;
+        if (utils::Shard* shard = utils::Shard::current()) {
+            for (const auto& address : shard->dns_cache().resolve(host, port)) {
+                fd = try_connect(address.storage.ss_family, reinterpret_cast<const sockaddr*>(&address.storage),
+                                 address.length, deadline, timed_out);
+                if (fd >= 0 || timed_out) break;
+            }
+        } else {
+            addrinfo hints = addrinfo();
+            hints.ai_family = AF_UNSPEC;
+            hints.ai_socktype = SOCK_STREAM;
+            addrinfo* results = nullptr;
+            int rc = getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &results);
+            if (rc != 0) throw std::runtime_error("getaddrinfo(" + host + ") failed: " + gai_strerror(rc));
+
+            for (addrinfo* ai = results; ai != nullptr && fd < 0 && !timed_out; ai = ai->ai_next) {
+                fd = try_connect(ai->ai_family, ai->ai_addr, ai->ai_addrlen, deadline, timed_out);
+            }
+            freeaddrinfo(results);
+        }
+        if (fd < 0 && timed_out) {
+            throw std::runtime_error("connect to " + host + ":" + std::to_string(port) + " timed out after " +
+                                     std::to_string(timeout.count()) + " ms");
+        }
+        if (fd < 0) throw std::runtime_error("connect to " + host + ":" + std::to_string(port) + " failed");
+        set_io_timeout(fd, timeout);
+        return fd;
+    }
+
+private:
+    static std::chrono::milliseconds remaining(std::chrono::steady_clock::time_point deadline) {
+        return std::chrono::ceil<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+    }
+
+    // Non-blocking connect, waited on with poll() until 'deadline'. The socket is switched back to
+    // blocking mode before it is returned.
+    static int try_connect(int family, const sockaddr* address, socklen_t length,
+                           std::chrono::steady_clock::time_point deadline, bool& timed_out) {
+        int fd = ::socket(family, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0) return -1;
+        int flags = fcntl(fd, F_GETFL, 0);
+        if (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) != 0 ||
+            (::connect(fd, address, length) != 0 && (errno != EINPROGRESS || !wait_connected(fd, deadline, timed_out))) ||
+            fcntl(fd, F_SETFL, flags) != 0) {
+            ::close(fd);
+            return -1;
+        }
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        return fd;
+    }
+
+    static bool wait_connected(int fd, std::chrono::steady_clock::time_point deadline, bool& timed_out) {
+        pollfd entry = pollfd();
+        entry.fd = fd;
+        entry.events = POLLOUT;
+        for (;;) {
+            long long wait_ms = remaining(deadline).count();
+            int rc = wait_ms > 0 ? ::poll(&entry, 1, static_cast<int>(std::min<long long>(wait_ms, INT_MAX))) : 0;
+            if (rc < 0 && errno == EINTR) continue;
+            if (rc == 0) timed_out = true;
+            if (rc <= 0) return false;
+            int error = 0;
+            socklen_t error_length = sizeof(error);
+            return getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &error_length) == 0 && error == 0;
+        }
+    }
+
+    TlsContext& context_;
+    utils::ThreadPool pool_;
+};
+
+} // namespace tls
+} // namespace http
+
+#endif // CPP_HTTP_CLIENT_WITH_OPENSSL
+
+#endif // CPP_HTTP_CLIENT_TLSCONTEXT_HPP
@@ -0,0 +1,131 @@
+#include "cpp_http_client/ThreadPool.hpp"
+#include <iostream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <future>
+#include <thread>
+#include <cstdlib> // For std::exit
+
+// Checks ThreadPool scheduling deterministically: a single worker is held on a gate task while
+// the tasks under test are queued, so the order it picks them in is decided by the scheduler alone.
+
+namespace {
+
+using http::utils::Priority;
+using http::utils::TaskOptions;
+using http::utils::ThreadPool;
+
+void check(bool condition, const std::string& what) {
+    if (!condition) {
+        std::cerr << "FAILED: " << what << std::endl;
+        std::exit(1);
+    }
+}
+
+TaskOptions with_priority(Priority priority) {
+    TaskOptions options;
+    options.priority = priority;
+    return options;
+}
+
+// Occupies the pool's only worker until release() is called.
+class Gate {
+public:
+    explicit Gate(ThreadPool& pool) : released_(release_.get_future().share()) {
+        std::promise<void> started;
+        std::future<void> running = started.get_future();
+        std::shared_future<void> released = released_;
+        done_ = pool.enqueue([&started, released] {
+            started.set_value();
+            released.wait();
+        });
+        running.wait();
+    }
+
+    void release() {
+        release_.set_value();
+        done_.get();
+    }
+
+private:
+    std::promise<void> release_;
+    std::shared_future<void> released_;
+    std::future<void> done_;
+};
+
+std::string join(const std::vector<std::string>& parts) {
+    std::string out;
+    for (const auto& part : parts) out += (out.empty() ? "" : ",") + part;
+    return out;
+}
+
+void test_priority_order() {
+    ThreadPool pool(1, std::chrono::hours(1)); // No aging within the test
+    std::vector<std::string> order; // Only the single worker appends
+    std::vector<std::future<void>> done;
+
+    Gate gate(pool);
+    done.push_back(pool.enqueue_with(with_priority(Priority::Low), [&order] { order.push_back("low1"); }));
+    done.push_back(pool.enqueue_with(with_priority(Priority::Normal), [&order] { order.push_back("normal1"); }));
+    done.push_back(pool.enqueue_with(with_priority(Priority::High), [&order] { order.push_back("high1"); }));
+    done.push_back(pool.enqueue_with(with_priority(Priority::Low), [&order] { order.push_back("low2"); }));
+    done.push_back(pool.enqueue_with(with_priority(Priority::High), [&order] { order.push_back("high2"); }));
+    done.push_back(pool.enqueue([&order] { order.push_back("normal2"); }));
+    gate.release();
+    for (auto& f : done) f.get();
+
+    check(join(order) == "high1,high2,normal1,normal2,low1,low2",
+          "classes served High, Normal, Low and FIFO within a class; got " + join(order));
+}
+
+void test_aging_promotes_old_low_task() {
+    const auto aging = std::chrono::milliseconds(20);
+    ThreadPool pool(1, aging);
+    std::vector<std::string> order;
+    std::vector<std::future<void>> done;
+
+    Gate gate(pool);
+    done.push_back(pool.enqueue_with(with_priority(Priority::Low), [&order] { order.push_back("low"); }));
+    // Low is two classes below High, so it must have waited two aging intervals
+    std::this_thread::sleep_for(aging * 2 + std::chrono::milliseconds(10));
+    done.push_back(pool.enqueue_with(with_priority(Priority::High), [&order] { order.push_back("high"); }));
+    gate.release();
+    for (auto& f : done) f.get();
+
+    check(join(order) == "low,high", "aged Low task runs before a newer High task; got " + join(order));
+}
+
+void test_expired_task_is_not_run() {
+    ThreadPool pool(1, std::chrono::hours(1));
+    bool ran = false;
+
+    Gate gate(pool);
+    TaskOptions options;
+    options.deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(5);
+    std::future<int> expired = pool.enqueue_with(options, [&ran] { ran = true; return 1; });
+    std::future<int> on_time = pool.enqueue([] { return 2; });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20)); // Deadline passes while queued
+    gate.release();
+
+    bool threw = false;
+    try {
+        expired.get();
+    } catch (const http::utils::DeadlineExceeded&) {
+        threw = true;
+    }
+    check(threw, "expired task's future throws DeadlineExceeded");
+    check(on_time.get() == 2, "task without a deadline still runs");
+    check(!ran, "expired task is not run");
+    check(pool.expired_count() == 1, "expired_count() is 1, got " + std::to_string(pool.expired_count()));
+}
+
+} // namespace
+
+int main() {
+    test_priority_order();
+    test_aging_promotes_old_low_task();
+    test_expired_task_is_not_run();
+    std::cout << "ThreadPool scheduling: all checks passed" << std::endl;
+    return 0;
+}